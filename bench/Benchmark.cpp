@@ -0,0 +1,432 @@
+#include "RoadNetworkGenerator.hpp"
+#include "../include/CapitalFinder.hpp"
+#include "../include/EdgeListLoader.hpp"
+#include "../include/EulerianCycle.hpp"
+#include "../include/Graph.hpp"
+#include "../include/GraphAnalysis.hpp"
+#include "../include/HungarianAlgorithm.hpp"
+#include "../include/Kosaraju.hpp"
+#include "../include/OutputWriter.hpp"
+#include "../include/Parallel.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fcntl.h>
+#include <iostream>
+#include <random>
+#include <string>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+// Microbenchmarks de cada etapa do programa sobre uma malha sintética (ou um arquivo de entrada), com os
+// resultados em JSON na saída padrão: tempo da melhor repetição, vazão e pico de memória residente do processo
+
+static void printUsage(const char* program) {
+    std::cerr << "Uso: " << program << " [opções]\n"
+              << "  --generate             apenas escreve a malha gerada na saída padrão\n"
+              << "  --input ARQUIVO        mede sobre um arquivo de entrada em vez de gerar a malha\n"
+              << "  --cities N             número de cidades (padrão 16)\n"
+              << "  --grid N               cruzamentos por lado de cada cidade (padrão: derivado de --edges)\n"
+              << "  --edges N              número aproximado de estradas (padrão 100000)\n"
+              << "  --one-way R            fração das ruas de mão única (padrão 0.3)\n"
+              << "  --random-directions R  fração das ruas de mão única com sentido sorteado (padrão 0)\n"
+              << "  --highways N           rodovias por cidade (padrão 2)\n"
+              << "  --one-way-highways R   fração das rodovias de mão única (padrão 0)\n"
+              << "  --seed N               semente do gerador (padrão 1)\n"
+              << "  --threads L            números de threads separados por vírgula (padrão: 1 e todas)\n"
+              << "  --repeat N             repetições de cada medida; vale a melhor (padrão 3)\n"
+              << "  --matrix N             tamanho da matriz de custos do Algoritmo Húngaro (padrão 500)\n"
+              << "  --max-sources N        maior grafo medido com as buscas de capital sobre todas as origens\n"
+              << "                         (padrão 20000 vértices)\n"
+              << "  --max-balancing N      maior desbalanço da maior componente medido no balanceamento\n"
+              << "                         (padrão 2000 unidades)\n";
+}
+
+struct BenchmarkOptions {
+    GeneratorOptions generator;
+    bool generateOnly = false;
+    std::string inputPath;
+    std::vector<unsigned> threadCounts;
+    unsigned repeat = 3;
+    size_t matrixSize = 500;
+    uint64_t maxSources = 20000;
+    uint64_t maxBalancing = 2000;
+};
+
+static bool parseThreadCounts(const std::string& list, std::vector<unsigned>& counts) {
+    counts.clear();
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+        unsigned count = static_cast<unsigned>(std::strtoul(list.substr(start, end - start).c_str(), nullptr, 10));
+        if (count == 0) {
+            return false;
+        }
+        counts.push_back(count);
+        start = end + 1;
+    }
+    return !counts.empty();
+}
+
+static bool parseArguments(int argc, char* argv[], BenchmarkOptions& options) {
+    GeneratorOptions& generator = options.generator;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--generate") {
+            options.generateOnly = true;
+        } else if (arg == "--input" && hasValue) {
+            options.inputPath = argv[++i];
+        } else if (arg == "--cities" && hasValue) {
+            generator.cities = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--grid" && hasValue) {
+            generator.gridSide = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--edges" && hasValue) {
+            generator.targetEdges = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--one-way" && hasValue) {
+            generator.oneWayRatio = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--random-directions" && hasValue) {
+            generator.randomDirections = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--highways" && hasValue) {
+            generator.highwaysPerCity = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--one-way-highways" && hasValue) {
+            generator.oneWayHighways = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--seed" && hasValue) {
+            generator.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--threads" && hasValue) {
+            if (!parseThreadCounts(argv[++i], options.threadCounts)) {
+                return false;
+            }
+        } else if (arg == "--repeat" && hasValue) {
+            options.repeat = std::max(1u, static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10)));
+        } else if (arg == "--matrix" && hasValue) {
+            options.matrixSize = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--max-sources" && hasValue) {
+            options.maxSources = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--max-balancing" && hasValue) {
+            options.maxBalancing = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            return false;
+        }
+    }
+    if (options.threadCounts.empty()) {
+        options.threadCounts = {1};
+        if (resolveThreadCount(0) > 1) {
+            options.threadCounts.push_back(resolveThreadCount(0));
+        }
+    }
+    return true;
+}
+
+// Resultado de uma medida: items processados pela melhor repetição, na unidade indicada
+struct Measurement {
+    std::string stage;
+    std::string variant;
+    unsigned threads;
+    double seconds;
+    uint64_t items;
+    std::string unit;
+    long peakRssKB;
+};
+
+static long peakRssKB() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss; // Em KB no Linux
+}
+
+// Melhor tempo entre as repetições; setup roda antes de cada uma, fora da medida
+template <typename Setup, typename Body>
+static double bestTime(unsigned repeat, Setup setup, Body body) {
+    double best = 0;
+    for (unsigned r = 0; r < repeat; ++r) {
+        setup();
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        best = r == 0 ? seconds : std::min(best, seconds);
+    }
+    return best;
+}
+
+class Report {
+public:
+    void add(const std::string& stage, const std::string& variant, unsigned threads, double seconds,
+             uint64_t items, const std::string& unit) {
+        results.push_back({stage, variant, threads, seconds, items, unit, peakRssKB()});
+    }
+
+    void skip(const std::string& stage, const std::string& variant, const std::string& reason) {
+        skipped.push_back("{\"stage\": \"" + stage + "\", \"variant\": \"" + variant + "\", \"reason\": \"" +
+                          reason + "\"}");
+    }
+
+    void print(std::ostream& out, const std::string& graphJson) const {
+        out << "{\"graph\": " << graphJson << ",\n \"results\": [";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Measurement& m = results[i];
+            out << (i ? ",\n  " : "\n  ") << "{\"stage\": \"" << m.stage << "\", \"variant\": \"" << m.variant
+                << "\", \"threads\": " << m.threads << ", \"seconds\": " << m.seconds << ", \"items\": " << m.items
+                << ", \"unit\": \"" << m.unit << "\", \"throughput\": " << (m.seconds > 0 ? m.items / m.seconds : 0)
+                << ", \"peakRssKB\": " << m.peakRssKB << "}";
+        }
+        out << "],\n \"skipped\": [";
+        for (size_t i = 0; i < skipped.size(); ++i) {
+            out << (i ? ",\n  " : "\n  ") << skipped[i];
+        }
+        out << "]}" << std::endl;
+    }
+
+private:
+    std::vector<Measurement> results;
+    std::vector<std::string> skipped;
+};
+
+// Subgrafo da componente c com os identificadores locais da análise
+static Subgraph componentSubgraph(const CSRGraph& graph, const GraphAnalysis& analysis, uint32_t c) {
+    const auto& vertices = analysis.components[c];
+    Subgraph subgraph(vertices.size());
+    for (uint32_t local = 0; local < vertices.size(); ++local) {
+        for (uint32_t neighbor : graph.neighbors(vertices[local])) {
+            if (analysis.componentOf[neighbor] == c) {
+                subgraph[local].push_back(analysis.localIndex[neighbor]);
+            }
+        }
+    }
+    return subgraph;
+}
+
+static uint64_t countEdges(const Subgraph& subgraph) {
+    uint64_t edges = 0;
+    for (const auto& adjacency : subgraph) {
+        edges += adjacency.size();
+    }
+    return edges;
+}
+
+static bool loadGraph(const std::string& path, Graph& graph) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    bool loaded = EdgeListLoader::load(fd, graph);
+    close(fd);
+    return loaded;
+}
+
+int main(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (options.generateOnly) {
+        OutputWriter out(STDOUT_FILENO);
+        RoadNetworkGenerator::generate(options.generator, out);
+        return out.flush() ? 0 : 1;
+    }
+
+    Report report;
+    const unsigned repeat = options.repeat;
+
+    // Malha gerada em um arquivo temporário, lido depois pelo carregador como uma entrada qualquer
+    std::string path = options.inputPath;
+    if (path.empty()) {
+        const char* directory = std::getenv("TMPDIR");
+        path = std::string(directory ? directory : "/tmp") + "/roadsXXXXXX";
+        int fd = mkstemp(&path[0]);
+        if (fd < 0) {
+            std::cerr << "Não foi possível criar o arquivo temporário" << std::endl;
+            return 1;
+        }
+        auto start = std::chrono::steady_clock::now();
+        bool written;
+        {
+            OutputWriter out(fd);
+            RoadNetworkGenerator::generate(options.generator, out);
+            written = out.flush();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        close(fd);
+        if (!written) {
+            std::cerr << "Não foi possível gravar a malha gerada" << std::endl;
+            unlink(path.c_str());
+            return 1;
+        }
+        struct stat info{};
+        stat(path.c_str(), &info);
+        report.add("generate", "grid", 1, seconds, static_cast<uint64_t>(info.st_size), "bytes");
+    }
+
+    // Leitura da entrada (internação dos nomes e estradas por identificador)
+    Graph graph;
+    bool loaded = true;
+    double parseSeconds = bestTime(repeat, [] {}, [&] {
+        Graph fresh;
+        loaded = loaded && loadGraph(path, fresh);
+    });
+    loaded = loaded && loadGraph(path, graph);
+    if (options.inputPath.empty()) {
+        unlink(path.c_str());
+    }
+    if (!loaded) {
+        std::cerr << "Entrada inválida: " << path << std::endl;
+        return 1;
+    }
+
+    // Congelamento em CSR (apenas uma vez: a CSR é memorizada pelo grafo)
+    auto start = std::chrono::steady_clock::now();
+    const CSRGraph& csr = graph.csr();
+    double csrSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const uint32_t n = csr.numVertices();
+    const uint64_t m = csr.numEdges();
+    report.add("parse", "mmap", 1, parseSeconds, m, "edges");
+    report.add("csr", "two-pass", 1, csrSeconds, m, "edges");
+
+    std::vector<std::string> names(n);
+    for (uint32_t v = 0; v < n; ++v) {
+        names[v] = graph.nameOf(v);
+    }
+
+    // Componentes fortemente conectadas
+    std::vector<std::vector<uint32_t>> components;
+    std::vector<uint32_t> componentOf;
+    report.add("scc", "kosaraju", 1,
+               bestTime(repeat, [] {}, [&] { components = Kosaraju::findConnectedComponents(csr); }), m, "edges");
+    report.add("scc", "tarjan", 1, bestTime(repeat, [] {}, [&] {
+        GraphAnalysis::decompose(csr, SCCAlgorithm::Tarjan, 1, components, componentOf);
+    }), m, "edges");
+    for (unsigned threads : options.threadCounts) {
+        report.add("scc", "parallel", threads, bestTime(repeat, [] {}, [&] {
+            GraphAnalysis::decompose(csr, SCCAlgorithm::Parallel, threads, components, componentOf);
+        }), m, "edges");
+    }
+
+    // Capital: busca podada e, em grafos pequenos o bastante, as buscas sobre todas as origens
+    CapitalOptions capitalOptions;
+    capitalOptions.mode = CapitalMode::Pruned;
+    report.add("capital", "pruned", 1, bestTime(repeat, [] {}, [&] {
+        CapitalFinder::findCapital(csr, names, capitalOptions);
+    }), n, "vertices");
+    const std::pair<CapitalMode, const char*> allSources[] = {{CapitalMode::Parallel, "parallel"},
+                                                             {CapitalMode::BitParallel, "bitparallel"}};
+    for (const auto& mode : allSources) {
+        if (n > options.maxSources) {
+            report.skip("capital", mode.second, "more vertices than --max-sources");
+            continue;
+        }
+        for (unsigned threads : options.threadCounts) {
+            capitalOptions.mode = mode.first;
+            capitalOptions.numThreads = threads;
+            report.add("capital", mode.second, threads, bestTime(repeat, [] {}, [&] {
+                CapitalFinder::findCapital(csr, names, capitalOptions);
+            }), n, "vertices");
+        }
+    }
+
+    // Análise completa, usada pelas etapas das rotas
+    AnalysisOptions analysisOptions;
+    analysisOptions.capital.numThreads = options.threadCounts.back();
+    GraphAnalysis analysis;
+    report.add("analysis", "default", options.threadCounts.back(), bestTime(repeat, [] {}, [&] {
+        analysis = GraphAnalysis::compute(csr, names, analysisOptions);
+    }), m, "edges");
+
+    // Balanceamento e ciclo Euleriano na maior componente
+    uint32_t largest = 0;
+    for (uint32_t c = 0; c < analysis.components.size(); ++c) {
+        if (analysis.components[c].size() > analysis.components[largest].size()) {
+            largest = c;
+        }
+    }
+    const Subgraph original = n ? componentSubgraph(csr, analysis, largest) : Subgraph();
+    const std::vector<int> balance = EulerianCycle::calculateBalance(original);
+    uint64_t unbalancedUnits = 0;
+    for (int value : balance) {
+        unbalancedUnits += value > 0 ? value : 0;
+    }
+    const uint64_t componentEdges = countEdges(original);
+    Subgraph subgraph;
+    auto copySubgraph = [&] { subgraph = original; };
+
+    // O custo do balanceamento cresce com o desbalanço (um caminho aumentante ou uma linha por unidade)
+    Subgraph eulerian;
+    const std::pair<BalancingMode, const char*> balancings[] = {{BalancingMode::MinCostFlow, "flow"},
+                                                               {BalancingMode::Hungarian, "hungarian"},
+                                                               {BalancingMode::SparseHungarian, "sparse"}};
+    for (const auto& mode : balancings) {
+        if (unbalancedUnits > options.maxBalancing) {
+            report.skip("eulerize", mode.second, "more unbalanced units than --max-balancing");
+            continue;
+        }
+        // O fluxo de custo mínimo é sequencial; os emparelhamentos paralelizam as BFS das distâncias
+        const std::vector<unsigned> sequential{1};
+        for (unsigned threads : mode.first == BalancingMode::MinCostFlow ? sequential : options.threadCounts) {
+            report.add("eulerize", mode.second, threads, bestTime(repeat, copySubgraph, [&] {
+                EulerianCycle::transformToEulerian(subgraph, balance, mode.first, threads);
+            }), componentEdges, "edges");
+            if (eulerian.empty()) {
+                eulerian = subgraph;
+            }
+        }
+    }
+
+    if (!eulerian.empty()) {
+        report.add("cycle", "hierholzer", 1, bestTime(repeat, [] {}, [&] {
+            EulerianCycle::findCycleFromStart(eulerian, 0);
+        }), countEdges(eulerian), "edges");
+    }
+
+    // Emparelhamento de custo mínimo sobre uma matriz densa pseudoaleatória (e a sua versão esparsa)
+    CostMatrix costs(options.matrixSize, options.matrixSize);
+    std::mt19937 random(static_cast<uint32_t>(options.generator.seed)); // Sequência fixada pelo padrão
+    for (int& value : costs.values) {
+        value = static_cast<int>(random() % 1000);
+    }
+    HungarianAlgorithm hungarian;
+    report.add("hungarian", "dense", 1, bestTime(repeat, [] {}, [&] { hungarian.solve(costs); }),
+               options.matrixSize, "rows");
+    const SparseCostMatrix sparse = HungarianAlgorithm::cheapestCandidates(costs, 16);
+    report.add("hungarian", "sparse", 1, bestTime(repeat, [] {}, [&] { hungarian.solve(sparse); }),
+               options.matrixSize, "rows");
+
+    // Rotas de patrulhamento (primeira chamada) e a escrita delas, já memorizadas, com nomes
+    graph.setAnalysisOptions(analysisOptions);
+    graph.analysis();
+    start = std::chrono::steady_clock::now();
+    graph.streamPatrolRoutes([](const std::vector<uint32_t>&) {});
+    report.add("routes", "default", options.threadCounts.back(),
+               std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), m, "edges");
+
+    int devNull = open("/dev/null", O_WRONLY);
+    uint64_t bytes = 0;
+    double outputSeconds = bestTime(repeat, [&] { bytes = 0; }, [&] {
+        OutputWriter out(devNull);
+        graph.streamPatrolRoutes([&](const std::vector<uint32_t>& route) {
+            for (size_t i = 0; i < route.size(); ++i) {
+                if (i) out.put(' ');
+                const std::string& name = graph.nameOf(route[i]);
+                out.write(name);
+                bytes += name.size() + 1;
+            }
+            out.put('\n');
+        });
+        out.flush();
+    });
+    report.add("output", "buffered", 1, outputSeconds, bytes, "bytes");
+    close(devNull);
+
+    std::string graphJson = "{\"vertices\": " + std::to_string(n) + ", \"edges\": " + std::to_string(m) +
+                            ", \"components\": " + std::to_string(analysis.components.size()) +
+                            ", \"largestComponent\": " +
+                            std::to_string(n ? analysis.components[largest].size() : 0) +
+                            ", \"unbalancedUnits\": " + std::to_string(unbalancedUnits) + "}";
+    report.print(std::cout, graphJson);
+    return 0;
+}
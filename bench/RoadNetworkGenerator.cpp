@@ -0,0 +1,138 @@
+#include "RoadNetworkGenerator.hpp"
+#include <algorithm>
+#include <cmath>
+
+// SplitMix64: sequência idêntica em qualquer plataforma, ao contrário das distribuições da biblioteca padrão
+class SplitMix64 {
+public:
+    explicit SplitMix64(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Inteiro uniforme em [0, bound)
+    uint64_t below(uint64_t bound) {
+        return static_cast<uint64_t>((static_cast<unsigned __int128>(next()) * bound) >> 64);
+    }
+
+    // Verdadeiro com probabilidade p (53 bits de precisão)
+    bool chance(double p) {
+        return static_cast<double>(next() >> 11) * 0x1.0p-53 < p;
+    }
+
+private:
+    uint64_t state;
+};
+
+// Cruzamento (x, y) de uma cidade
+struct Intersection {
+    uint32_t city;
+    uint32_t x;
+    uint32_t y;
+};
+
+uint32_t RoadNetworkGenerator::gridSide(const GeneratorOptions& options) {
+    if (options.gridSide != 0) {
+        return std::max<uint32_t>(options.gridSide, 2);
+    }
+    // Cada cidade tem 2 s (s - 1) ruas, com (2 - oneWayRatio) estradas em média por rua
+    const double perCity = static_cast<double>(options.targetEdges) / std::max<uint32_t>(options.cities, 1) /
+                           (2.0 * (2.0 - options.oneWayRatio));
+    const double side = 0.5 + std::sqrt(0.25 + perCity);
+    return std::max<uint32_t>(2, static_cast<uint32_t>(std::lround(side)));
+}
+
+uint64_t RoadNetworkGenerator::numVertices(const GeneratorOptions& options) {
+    const uint64_t side = gridSide(options);
+    return uint64_t(std::max<uint32_t>(options.cities, 1)) * side * side;
+}
+
+// Percorre todas as estradas da malha na ordem da saída; road(from, to) é chamada uma vez por estrada
+template <typename Road>
+static void forEachRoad(const GeneratorOptions& options, uint32_t side, Road road) {
+    SplitMix64 random(options.seed);
+    const uint32_t cities = std::max<uint32_t>(options.cities, 1);
+
+    // Rua entre dois cruzamentos vizinhos: mão dupla, ou mão única no sentido alternado (ou sorteado)
+    auto street = [&](const Intersection& a, const Intersection& b, bool forward) {
+        if (!random.chance(options.oneWayRatio)) {
+            road(a, b);
+            road(b, a);
+            return;
+        }
+        if (random.chance(options.randomDirections)) {
+            forward = random.below(2) == 0;
+        }
+        if (forward) {
+            road(a, b);
+        } else {
+            road(b, a);
+        }
+    };
+
+    for (uint32_t city = 0; city < cities; ++city) {
+        for (uint32_t y = 0; y < side; ++y) {
+            for (uint32_t x = 0; x < side; ++x) {
+                if (x + 1 < side) {
+                    street({city, x, y}, {city, x + 1, y}, y % 2 == 0); // Linhas pares seguem para leste
+                }
+                if (y + 1 < side) {
+                    street({city, x, y}, {city, x, y + 1}, x % 2 == 1); // Colunas ímpares seguem para o sul
+                }
+            }
+        }
+    }
+
+    // Rodovias: a primeira de cada cidade liga-a a uma cidade anterior (árvore geradora), as demais a
+    // cidades quaisquer; as de mão única seguem da cidade de menor para a de maior índice
+    auto randomIntersection = [&](uint32_t city) {
+        return Intersection{city, static_cast<uint32_t>(random.below(side)), static_cast<uint32_t>(random.below(side))};
+    };
+    for (uint32_t city = 1; city < cities; ++city) {
+        for (uint32_t h = 0; h < options.highwaysPerCity; ++h) {
+            uint32_t other = static_cast<uint32_t>(h == 0 ? random.below(city) : random.below(cities - 1));
+            if (h != 0 && other >= city) {
+                ++other; // Nunca a própria cidade
+            }
+            Intersection a = randomIntersection(std::min(city, other));
+            Intersection b = randomIntersection(std::max(city, other));
+            road(a, b);
+            if (!random.chance(options.oneWayHighways)) {
+                road(b, a);
+            }
+        }
+    }
+}
+
+// Nome de um cruzamento: c<cidade>_<x>_<y>
+static void writeName(OutputWriter& out, const Intersection& node) {
+    out.put('c');
+    out.writeNumber(node.city);
+    out.put('_');
+    out.writeNumber(node.x);
+    out.put('_');
+    out.writeNumber(node.y);
+}
+
+void RoadNetworkGenerator::generate(const GeneratorOptions& options, OutputWriter& out) {
+    const uint32_t side = gridSide(options);
+
+    // Primeira passada só conta as estradas, para o cabeçalho
+    uint64_t numEdges = 0;
+    forEachRoad(options, side, [&numEdges](const Intersection&, const Intersection&) { ++numEdges; });
+
+    out.writeNumber(numVertices(options));
+    out.put(' ');
+    out.writeNumber(numEdges);
+    out.put('\n');
+    forEachRoad(options, side, [&out](const Intersection& from, const Intersection& to) {
+        writeName(out, from);
+        out.put(' ');
+        writeName(out, to);
+        out.put('\n');
+    });
+}
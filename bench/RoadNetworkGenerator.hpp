@@ -0,0 +1,34 @@
+#ifndef ROAD_NETWORK_GENERATOR_HPP
+#define ROAD_NETWORK_GENERATOR_HPP
+
+#include "../include/OutputWriter.hpp"
+#include <cstdint>
+
+// Parâmetros de uma malha viária sintética: cidades em grade ligadas por rodovias
+struct GeneratorOptions {
+    uint32_t cities = 16;          // Número de cidades
+    uint32_t gridSide = 0;         // Cruzamentos por lado de cada cidade (0 = derivado de targetEdges)
+    uint64_t targetEdges = 100000; // Número aproximado de estradas, usado quando gridSide = 0
+    double oneWayRatio = 0.3;      // Fração das ruas de mão única
+    double randomDirections = 0.0; // Fração das ruas de mão única com sentido sorteado (cria poços e fontes)
+    uint32_t highwaysPerCity = 2;  // Rodovias que partem de cada cidade (a primeira forma a espinha dorsal)
+    double oneWayHighways = 0.0;   // Fração das rodovias de mão única (da cidade de menor para a de maior índice)
+    uint64_t seed = 1;
+};
+
+// Gera, de forma determinística (mesma semente, mesma saída em qualquer plataforma), uma malha direcionada
+// no formato de entrada do programa. Cada cidade é uma grade de ruas em que as de mão única alternam o
+// sentido por linha e coluna, como em um centro urbano real, o que a mantém fortemente conexa; ruas com
+// sentido sorteado e rodovias de mão única entre cidades controlam a estrutura de SCCs (com todas as rodovias
+// de mão única, cada cidade é uma componente e a condensação é um DAG). A saída é gerada em duas passadas
+// com o mesmo gerador pseudoaleatório, então nenhuma estrada é guardada em memória
+class RoadNetworkGenerator {
+public:
+    static void generate(const GeneratorOptions& options, OutputWriter& out);
+
+    // Lado da grade efetivamente usado e número de vértices da malha
+    static uint32_t gridSide(const GeneratorOptions& options);
+    static uint64_t numVertices(const GeneratorOptions& options);
+};
+
+#endif // ROAD_NETWORK_GENERATOR_HPP
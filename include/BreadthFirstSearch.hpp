@@ -0,0 +1,80 @@
+#ifndef BREADTH_FIRST_SEARCH_HPP
+#define BREADTH_FIRST_SEARCH_HPP
+
+#include "CSRGraph.hpp"
+#include <cstdint>
+#include <vector>
+
+// BFS sobre a CSR usada por todos os cálculos de distância sem pesos. Cada instância guarda buffers
+// reaproveitados entre as buscas (uma instância por thread): a distância de um vértice só vale se ele estiver
+// marcado com a época da busca atual, então uma nova busca não reinicializa os V vértices.
+// A busca é por níveis e escolhe o passo de cada nível pela heurística de Beamer: de cima para baixo, a
+// fronteira expande as suas estradas; de baixo para cima, cada vértice ainda não visitado procura um
+// predecessor na fronteira (mapa de bits) pela lista oposta da CSR e para no primeiro. Passa para baixo-cima
+// quando as estradas da fronteira superam 1/ALPHA das ainda não examinadas, e volta quando a fronteira
+// fica menor que 1/BETA dos vértices
+class BreadthFirstSearch {
+public:
+    static constexpr uint32_t UNVISITED = UINT32_MAX;
+
+    // Sentido das estradas percorridas: distâncias a partir da origem ou até ela
+    enum class Direction { Forward, Reverse };
+
+    // Busca a partir de source. afterLevel(depth, begin, end) recebe os vértices do nível depth assim que o
+    // nível inteiro é conhecido (o nível 0 é a própria origem) e retorna false para interromper a busca.
+    // Retorna quantos vértices foram alcançados (incluindo o último nível entregue)
+    template <typename LevelVisitor>
+    size_t run(const CSRGraph& graph, uint32_t source, Direction direction, LevelVisitor afterLevel) {
+        start(graph, source);
+        size_t levelBegin = 0;
+        for (uint32_t depth = 0;; ++depth) {
+            const size_t levelEnd = order.size();
+            if (!afterLevel(depth, order.data() + levelBegin, order.data() + levelEnd)) {
+                break;
+            }
+            expand(graph, direction, depth, levelBegin, levelEnd);
+            if (order.size() == levelEnd) {
+                break;
+            }
+            levelBegin = levelEnd;
+        }
+        return order.size();
+    }
+
+    // Busca completa, sem interrupção
+    size_t run(const CSRGraph& graph, uint32_t source, Direction direction = Direction::Forward) {
+        return run(graph, source, direction, [](uint32_t, const uint32_t*, const uint32_t*) { return true; });
+    }
+
+    // Distância de v na última busca (UNVISITED se não foi alcançado)
+    uint32_t distance(uint32_t v) const { return marks[v].epoch == epoch ? marks[v].depth : UNVISITED; }
+
+    // Vértices alcançados na última busca, nível a nível
+    const std::vector<uint32_t>& visited() const { return order; }
+
+    // Estradas examinadas por esta instância desde a sua criação, nos dois tipos de passo
+    uint64_t edgesScanned() const { return scanned; }
+
+private:
+    static constexpr uint64_t ALPHA = 14;
+    static constexpr uint64_t BETA = 24;
+
+    // Época e distância lado a lado, para que a verificação e a atribuição toquem uma única linha de cache
+    struct Mark {
+        uint32_t epoch = 0;
+        uint32_t depth = 0;
+    };
+
+    std::vector<Mark> marks;
+    std::vector<uint32_t> order;
+    std::vector<uint64_t> frontierBits;
+    uint32_t epoch = 0;
+    bool bottomUp = false;
+    uint64_t unexploredEdges = 0;
+    uint64_t scanned = 0;
+
+    void start(const CSRGraph& graph, uint32_t source);
+    void expand(const CSRGraph& graph, Direction direction, uint32_t depth, size_t begin, size_t end);
+};
+
+#endif // BREADTH_FIRST_SEARCH_HPP
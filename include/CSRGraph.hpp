@@ -0,0 +1,95 @@
+#ifndef CSR_GRAPH_HPP
+#define CSR_GRAPH_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <utility>
+
+// Intervalo contíguo de vizinhos dentro do vetor de destinos da CSR
+struct NeighborRange {
+    const uint32_t* first;
+    const uint32_t* last;
+
+    const uint32_t* begin() const { return first; }
+    const uint32_t* end() const { return last; }
+    size_t size() const { return static_cast<size_t>(last - first); }
+    bool empty() const { return first == last; }
+};
+
+// Ponteiros para os vetores de uma CSR (deslocamentos e destinos, diretos e reversos, e o peso de cada
+// estrada na ordem dos destinos diretos, nulo quando todas as estradas têm peso 1)
+struct CSRArrays {
+    const uint32_t* offsets;
+    const uint32_t* targets;
+    const uint32_t* reverseOffsets;
+    const uint32_t* reverseTargets;
+    const uint32_t* weights = nullptr;
+};
+
+// Grafo direcionado congelado em formato CSR (Compressed Sparse Row), com vértices
+// identificados por inteiros densos e listas de adjacência direta e reversa
+class CSRGraph {
+public:
+    CSRGraph() { bindStorage(); }
+
+    // Constrói a CSR em duas passadas (contagem e preenchimento), preservando a ordem de inserção das arestas.
+    // weights, se não vazio, traz o peso de cada aresta na mesma ordem de edges
+    CSRGraph(uint32_t numVertices, const std::vector<std::pair<uint32_t, uint32_t>>& edges,
+             const std::vector<uint32_t>& weights = {});
+
+    // CSR que apenas enxerga vetores já prontos em memória externa (ex.: um snapshot mapeado), sem copiá-los;
+    // owner mantém essa memória viva enquanto houver cópias do grafo
+    static CSRGraph view(uint32_t numVertices, size_t numEdges, const CSRArrays& arrays,
+                         std::shared_ptr<const void> owner);
+
+    // As cópias de uma CSR própria passam a apontar para os seus próprios vetores
+    CSRGraph(const CSRGraph& other);
+    CSRGraph& operator=(const CSRGraph& other);
+    CSRGraph(CSRGraph&&) noexcept = default;
+    CSRGraph& operator=(CSRGraph&&) noexcept = default;
+
+    uint32_t numVertices() const { return vertexCount; }
+    size_t numEdges() const { return edgeCount; }
+    const CSRArrays& arrays() const { return data; }
+    bool weighted() const { return data.weights != nullptr; }
+
+    NeighborRange neighbors(uint32_t vertex) const {
+        return {data.targets + data.offsets[vertex], data.targets + data.offsets[vertex + 1]};
+    }
+
+    NeighborRange reverseNeighbors(uint32_t vertex) const {
+        return {data.reverseTargets + data.reverseOffsets[vertex],
+                data.reverseTargets + data.reverseOffsets[vertex + 1]};
+    }
+
+    // Pesos das estradas de saída, alinhados com neighbors(vertex); só vale em grafos com pesos
+    const uint32_t* neighborWeights(uint32_t vertex) const { return data.weights + data.offsets[vertex]; }
+
+    uint32_t outDegree(uint32_t vertex) const { return data.offsets[vertex + 1] - data.offsets[vertex]; }
+    uint32_t inDegree(uint32_t vertex) const { return data.reverseOffsets[vertex + 1] - data.reverseOffsets[vertex]; }
+
+private:
+    uint32_t vertexCount = 0;
+    size_t edgeCount = 0;
+
+    // Vetores em uso: apontam para os vetores abaixo ou para a memória externa de uma view
+    CSRArrays data;
+    std::shared_ptr<const void> external;
+
+    // Lista direta: vizinhos de v estão em targets[offsets[v] .. offsets[v + 1])
+    std::vector<uint32_t> offsets{0};
+    std::vector<uint32_t> targets;
+
+    // Lista reversa: predecessores de v estão em reverseTargets[reverseOffsets[v] .. reverseOffsets[v + 1])
+    std::vector<uint32_t> reverseOffsets{0};
+    std::vector<uint32_t> reverseTargets;
+
+    // Peso de cada estrada, alinhado com targets (vazio sem pesos)
+    std::vector<uint32_t> weights;
+
+    void bindStorage();
+};
+
+#endif // CSR_GRAPH_HPP
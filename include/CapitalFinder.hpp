@@ -0,0 +1,98 @@
+#ifndef CAPITAL_FINDER_HPP
+#define CAPITAL_FINDER_HPP
+
+#include "CSRGraph.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Estratégia usada para calcular as somas de distâncias de todas as origens
+enum class CapitalMode {
+    Sequential,   // Uma BFS por origem, em uma única thread
+    Parallel,     // Origens distribuídas entre as threads, com buffers reutilizados por thread
+    BitParallel,  // 64 origens por passada, com máscaras de visitados/fronteira de 64 bits
+    Pruned,       // Apenas a componente fonte da condensação, com BFS interrompida por limite inferior
+    Approximate   // Somas estimadas por BFS reversas a partir de pivôs sorteados; só as melhores são verificadas
+};
+
+struct CapitalOptions {
+    CapitalMode mode = CapitalMode::Pruned;
+    unsigned numThreads = 0; // 0 usa todas as threads disponíveis
+    uint32_t samples = 64;   // Modo aproximado: pivôs sorteados para estimar as somas
+    uint32_t verified = 16;  // Modo aproximado: máximo de candidatos verificados com BFS completas
+};
+
+// Contadores da busca podada, para medir o efeito da poda em cada grafo
+struct CapitalSearchStats {
+    uint64_t candidates = 0;               // Vértices da componente fonte (únicos capazes de alcançar todos)
+    uint64_t filteredBySCC = 0;            // Vértices descartados por estarem fora da componente fonte
+    uint64_t bfsRuns = 0;                  // BFS (ou Dijkstra, com pesos) iniciadas, sem os descartados antes
+    uint64_t prunedRuns = 0;               // Candidatos descartados ou BFS interrompidas pelo limite inferior
+    uint64_t verticesVisited = 0;          // Vértices retirados da fila (fixados, com pesos) em todas as buscas
+    std::vector<uint64_t> prunedAtDepth;   // prunedAtDepth[d]: podas após expandir d níveis (distâncias distintas,
+                                           // com pesos; 0 = antes da busca)
+
+    // Modo aproximado
+    uint64_t samples = 0;                  // Pivôs sorteados (0 nos outros modos)
+    uint64_t verified = 0;                 // Candidatos com a soma exata calculada
+    double errorBound = 0;                 // Erro máximo das somas estimadas (exceto com probabilidade
+                                           // CapitalFinder::APPROXIMATION_FAILURE)
+    bool certified = false;                // O erro máximo descarta todos os candidatos não verificados
+};
+
+class CapitalFinder {
+public:
+    // Valor da soma para origens que não alcançam todos os vértices
+    static constexpr uint64_t UNREACHABLE = UINT64_MAX;
+
+    // Probabilidade de alguma soma estimada no modo aproximado se afastar da exata mais que o erro máximo
+    static constexpr double APPROXIMATION_FAILURE = 0.01;
+
+    // Calcula, para cada vértice, a soma das distâncias até todos os outros: BFS sem pesos; com pesos, um
+    // Dijkstra por origem (o modo bit-paralelo não se aplica e usa o Dijkstra em paralelo)
+    static std::vector<uint64_t> computeDistanceSums(const CSRGraph& graph, const CapitalOptions& options);
+
+    // Escolhe a capital: menor soma de distâncias, desempatando pelo menor nome (UINT32_MAX se não houver)
+    static uint32_t findCapital(const CSRGraph& graph, const std::vector<std::string>& names,
+                                const CapitalOptions& options, CapitalSearchStats* stats = nullptr);
+
+    // Busca podada: restringe os candidatos à componente fonte da condensação, ordena-os por um
+    // limite inferior barato (grau de saída) e interrompe cada BFS quando a soma parcial mais o
+    // limite inferior dos vértices restantes excede a melhor soma encontrada. Com pesos, cada busca é um
+    // Dijkstra interrompido pelo mesmo critério, com a menor distância ainda na fila no lugar do nível
+    static uint32_t findCapitalPruned(const CSRGraph& graph, const std::vector<std::string>& names,
+                                      CapitalSearchStats* stats = nullptr);
+
+    // Busca podada reaproveitando uma decomposição em componentes já calculada (componentOf[v] = componente de v).
+    // lowerBounds, se informado, recebe para cada candidato um limite inferior da sua soma (a soma exata quando
+    // a BFS termina; UNREACHABLE fora da componente fonte). seedNode é uma capital já conhecida cuja soma atual
+    // é seedSum: ela serve de limite inicial da poda e não é percorrida de novo
+    static uint32_t findCapitalPruned(const CSRGraph& graph, const std::vector<std::string>& names,
+                                      const std::vector<std::vector<uint32_t>>& components,
+                                      const std::vector<uint32_t>& componentOf,
+                                      CapitalSearchStats* stats = nullptr,
+                                      std::vector<uint64_t>* lowerBounds = nullptr,
+                                      uint32_t seedNode = UINT32_MAX, uint64_t seedSum = UNREACHABLE);
+
+    // Busca aproximada para grafos muito grandes. Cada pivô sorteado p contribui com d(v, p) para a estimativa
+    // n / k * soma dos d(v, p) de cada candidato v da componente fonte (uma BFS reversa por pivô). O erro
+    // máximo vem da desigualdade de Hoeffding, com as distâncias limitadas pela excentricidade de um candidato
+    // mais a maior distância até ele. Os candidatos de menor estimativa têm a soma exata calculada por BFS
+    // completas em paralelo, até options.verified deles ou até o erro máximo descartar os restantes; a capital
+    // é a menor soma exata entre os verificados, desempatando pelo nome. Com pesos, usa a busca podada exata
+    static uint32_t findCapitalApproximate(const CSRGraph& graph, const std::vector<std::string>& names,
+                                           const std::vector<std::vector<uint32_t>>& components,
+                                           const std::vector<uint32_t>& componentOf, const CapitalOptions& options,
+                                           CapitalSearchStats* stats = nullptr);
+
+private:
+    // Componente fonte da condensação, se for única (UINT32_MAX se houver mais de uma)
+    static uint32_t findSourceComponent(const CSRGraph& graph, const std::vector<std::vector<uint32_t>>& components,
+                                        const std::vector<uint32_t>& componentOf);
+
+    static void sumsBySingleSourceBFS(const CSRGraph& graph, unsigned numThreads, std::vector<uint64_t>& sums);
+    static void sumsByBitParallelBFS(const CSRGraph& graph, unsigned numThreads, std::vector<uint64_t>& sums);
+    static void sumsByDijkstra(const CSRGraph& graph, unsigned numThreads, std::vector<uint64_t>& sums);
+};
+
+#endif // CAPITAL_FINDER_HPP
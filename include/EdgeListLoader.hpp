@@ -0,0 +1,65 @@
+#ifndef EDGE_LIST_LOADER_HPP
+#define EDGE_LIST_LOADER_HPP
+
+#include "Graph.hpp"
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+// Conteúdo completo de um descritor de arquivo: mapeado em memória quando é um arquivo regular,
+// ou lido para um único buffer caso contrário (pipes, terminais). Uma leitura interrompida por sinal é
+// refeita; qualquer outro erro de leitura deixa o buffer marcado como incompleto (good() == false)
+class InputBuffer {
+public:
+    explicit InputBuffer(int fd);
+    ~InputBuffer();
+    InputBuffer(const InputBuffer&) = delete;
+    InputBuffer& operator=(const InputBuffer&) = delete;
+
+    const char* begin() const { return data; }
+    const char* end() const { return data + length; }
+    bool good() const { return !failed; }
+
+private:
+    const char* data = nullptr;
+    size_t length = 0;
+    bool mapped = false;
+    bool failed = false;
+    std::vector<char> storage;
+};
+
+// Divide o buffer em tokens separados por espaço em branco, devolvidos como string_view sobre o próprio
+// buffer; o fim de cada token é localizado oito bytes por vez
+class TokenScanner {
+public:
+    TokenScanner(const char* begin, const char* end) : position(begin), limit(end) {}
+
+    // Avança para o próximo token; retorna false ao fim da entrada
+    bool next(std::string_view& token);
+
+    // Como next, mas sem passar do fim da linha atual; retorna false se a linha não tiver mais tokens
+    bool nextOnLine(std::string_view& token);
+
+private:
+    const char* position;
+    const char* limit;
+};
+
+// Carrega o formato de entrada ("numCentros numEstradas" seguido de pares "origem destino") diretamente
+// no grafo: nomes internados a partir das views e arestas acrescentadas por identificador. Como no formato
+// original, as estradas podem estar dispostas em qualquer espaçamento. Uma entrada com pesos é declarada pela
+// marca WEIGHTED_MARKER na linha do cabeçalho ("numCentros numEstradas weighted"), e então cada estrada vem
+// como "origem destino peso", com pesos inteiros de 0 a 2^32 - 1
+class EdgeListLoader {
+public:
+    // Lê todo o descritor; retorna false se a leitura falhar, o cabeçalho for inválido, faltarem estradas ou
+    // um peso for inválido
+    static bool load(int fd, Graph& graph);
+
+    // Converte um peso de estrada; retorna false se o token não for um inteiro de 32 bits sem sinal
+    static bool parseWeight(std::string_view token, uint32_t& weight);
+
+    static constexpr std::string_view WEIGHTED_MARKER = "weighted";
+};
+
+#endif // EDGE_LIST_LOADER_HPP
@@ -1,25 +1,58 @@
 #ifndef EULERIAN_CYCLE_HPP
 #define EULERIAN_CYCLE_HPP
 
-#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <memory_resource>
 #include <vector>
-#include <unordered_map>
+
+// Subgrafo de uma componente, indexado pelos identificadores locais dos vértices (0 .. |C| - 1)
+using Subgraph = std::vector<std::vector<uint32_t>>;
+
+// Algoritmo usado para escolher quais estradas duplicar no balanceamento
+enum class BalancingMode {
+    Hungarian,       // Emparelhamento mínimo sobre a matriz densa de distâncias (uma linha por unidade de desbalanço)
+    SparseHungarian, // Emparelhamento restrito aos destinos mais próximos de cada origem (aproximado)
+    MinCostFlow      // Fluxo de custo mínimo sobre as próprias estradas, sem materializar a matriz
+};
+
+// Custo do balanceamento das rotas de patrulhamento (problema do carteiro chinês)
+struct PatrolStats {
+    uint64_t balancedComponents = 0;  // Componentes que precisaram de estradas duplicadas
+    uint64_t unbalancedVertices = 0;  // Vértices com grau de entrada diferente do grau de saída
+    uint64_t extraDistance = 0;       // Estradas percorridas novamente (soma dos caminhos mínimos duplicados)
+};
 
 class EulerianCycle {
 public:
-    // Encontra um ciclo Euleriano a partir de um nó inicial
-    static std::vector<std::string> findCycleFromStart(
-        const std::unordered_map<std::string, std::vector<std::string>>& subgraph,
-        const std::string& startNode);
+    // Encontra um ciclo Euleriano a partir de um nó inicial; os cursores e o caminho atual vêm de memory
+    static std::vector<uint32_t> findCycleFromStart(const Subgraph& subgraph, uint32_t startNode,
+                                                    std::pmr::memory_resource* memory = std::pmr::get_default_resource());
 
-    // Verifica e ajusta um subgrafo para torná-lo Euleriano
-    static void transformToEulerian(
-        std::unordered_map<std::string, std::vector<std::string>>& subgraph,
-        const std::unordered_map<std::string, int>& balance);
+    // Torna o subgrafo Euleriano duplicando o conjunto de estradas de menor comprimento total que liga os
+    // vértices com excesso de entrada aos com excesso de saída. Retorna a distância extra total (número de
+    // estradas duplicadas); numThreads (0 = todas) vale apenas para as BFS do modo Hungarian, e memory recebe
+    // a rede do fluxo de custo mínimo
+    static uint64_t transformToEulerian(Subgraph& subgraph, const std::vector<int>& balance,
+                                        BalancingMode mode = BalancingMode::MinCostFlow, unsigned numThreads = 0,
+                                        std::pmr::memory_resource* memory = std::pmr::get_default_resource());
 
     // Calcula o balanceamento de graus dos vértices no subgrafo
-    static std::unordered_map<std::string, int> calculateBalance(
-        const std::unordered_map<std::string, std::vector<std::string>>& subgraph);
+    static std::vector<int> calculateBalance(const Subgraph& subgraph);
+
+private:
+    // Emparelha as unidades de desbalanço pelo Algoritmo Húngaro e duplica os caminhos mínimos dos pares;
+    // no modo esparso, cai para a matriz densa se as candidatas não admitirem um emparelhamento completo
+    static uint64_t balanceByMatching(Subgraph& subgraph, const std::vector<int>& balance, unsigned numThreads,
+                                      bool sparse);
+
+    // Resolve o fluxo de custo mínimo das origens aos destinos e duplica cada estrada tantas vezes quanto o seu fluxo
+    static uint64_t balanceByMinCostFlow(Subgraph& subgraph, const std::vector<int>& balance,
+                                         std::pmr::memory_resource* memory);
+
+    // BFS a partir de uma origem no subgrafo; parent recebe o predecessor de cada vértice no caminho mínimo
+    static void bfs(const Subgraph& subgraph, uint32_t source, std::vector<uint32_t>& distance,
+                    std::vector<uint32_t>& parent, std::vector<uint32_t>& queue);
 };
 
 #endif // EULERIAN_CYCLE_HPP
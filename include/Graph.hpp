@@ -1,35 +1,127 @@
 #ifndef GRAPH_HPP
 #define GRAPH_HPP
 
+#include "CSRGraph.hpp"
+#include "CapitalFinder.hpp"
+#include "GraphAnalysis.hpp"
+#include "EulerianCycle.hpp"
+#include "IncrementalAnalysis.hpp"
+#include <cstdint>
+#include <functional>
+#include "NameTable.hpp"
 #include <string>
+#include <string_view>
 #include <vector>
-#include <unordered_map>
-#include <unordered_set>
+#include <utility>
+
+// Alteração de uma estrada dentro de um lote de atualizações
+struct RoadUpdate {
+    enum Kind { Insert, Remove };
+    Kind kind;
+    std::string from;
+    std::string to;
+    uint32_t weight = 1; // Peso da estrada inserida (ignorado nas remoções)
+};
 
 class Graph {
 public:
     // Métodos básicos de construção do grafo
     void addNode(const std::string& location);
-    void addEdge(const std::string& from, const std::string& to);
+    void addEdge(const std::string& from, const std::string& to, uint32_t weight = 1);
+
+    // Construção em massa: interna nomes sem copiá-los antes da primeira ocorrência e adiciona arestas
+    // diretamente por identificador (usada pelo EdgeListLoader). O peso é o comprimento da estrada; com todos
+    // os pesos iguais a 1 o grafo continua sem pesos e as distâncias são contadas em estradas
+    uint32_t intern(std::string_view location);
+    void addEdge(uint32_t fromId, uint32_t toId, uint32_t weight = 1);
+    void reserve(size_t numNodes, size_t numEdges);
+
+    // Substitui o grafo por um já congelado (usado pelo GraphSnapshot); as arestas só voltam a ser
+    // materializadas se o grafo for alterado depois. restoreAnalysis instala uma análise já pronta
+    void loadFrozen(std::vector<std::string> names, CSRGraph graph);
+    void restoreAnalysis(GraphAnalysis analysis);
+
+    // Aplica um lote de inserções e remoções de estradas. As remoções valem para as estradas existentes antes
+    // do lote (uma ocorrência por remoção; estradas inexistentes são ignoradas). Se a análise já estava
+    // calculada, ela é atualizada incrementalmente e as rotas das componentes não tocadas são reaproveitadas.
+    // Retorna o número de alterações aplicadas
+    size_t applyUpdates(const std::vector<RoadUpdate>& updates);
 
     // Algoritmos e funcionalidades específicas
     std::string findCapital();
     std::vector<std::string> findSecondaryBattalions();
     std::vector<std::vector<std::string>> findPatrolRoutes();
+    std::vector<std::vector<uint32_t>> findPatrolRouteIds(); // Mesmas rotas, como identificadores
+
+    // Mesmas rotas, entregues a visit uma a uma na ordem da saída à medida que ficam prontas, sem copiá-las.
+    // visit pode ser chamada a partir das threads de cálculo, mas nunca por duas ao mesmo tempo
+    void streamPatrolRoutes(const std::function<void(const std::vector<uint32_t>&)>& visit);
+    size_t numPatrolRoutes(); // Quantas rotas streamPatrolRoutes entrega
     std::vector<std::vector<std::string>> findConnectedComponents();
 
+    // Configuração da análise (estratégia da capital, número de threads e algoritmo de SCC)
+    void setAnalysisOptions(const AnalysisOptions& options);
+    const AnalysisOptions& currentAnalysisOptions() const { return analysisOptions; }
+
+    // Análise completa do grafo, calculada uma única vez e invalidada por addNode/addEdge/setAnalysisOptions
+    const GraphAnalysis& analysis();
+
+    // Contadores da última busca de capital (preenchidos apenas no modo podado)
+    const CapitalSearchStats& capitalStats() { return analysis().capitalStats; }
+
+    // Custo do balanceamento da última chamada a findPatrolRoutes/findPatrolRouteIds/streamPatrolRoutes
+    const PatrolStats& patrolStats() const { return lastPatrolStats; }
+
+    // Acesso à representação interna (identificadores densos e CSR congelada)
+    uint32_t numVertices() const { return static_cast<uint32_t>(idToName.size()); }
+    const std::string& nameOf(uint32_t id) const { return idToName[id]; }
+    const std::vector<std::string>& names() const { return idToName; }
+    uint32_t idOf(std::string_view location) const; // NO_VERTEX se o nome não existe
+    const CSRGraph& csr();
+
+    // Identificador usado quando não há vértice (ex.: nenhuma capital alcança todos os centros)
+    static constexpr uint32_t NO_VERTEX = UINT32_MAX;
+
 private:
-    // Estrutura principal de representação do grafo
-    std::unordered_map<std::string, std::vector<std::string>> adjacencyList;
+    // Tabela de nomes internados: cada centro urbano recebe um identificador denso na ordem de aparição
+    NameTable nameTable;
+    std::vector<std::string> idToName;
+
+    // Posto de cada nome na ordem lexicográfica, usado para ordenar a saída sem comparar strings repetidamente
+    std::vector<uint32_t> nameRank;
+    bool nameRankValid = false;
+
+    // Arestas inseridas desde a criação; a CSR é reconstruída a partir delas quando o grafo muda
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    std::vector<uint32_t> edgeWeights; // Peso de cada aresta de edges; vazio enquanto todas pesam 1
+    CSRGraph frozenGraph;
+    bool frozenValid = false;
+    bool edgesInFrozenGraph = false; // Grafo carregado já congelado: edges ainda não contém as suas arestas
+
+    AnalysisOptions analysisOptions;
+
+    // Resultado memorizado da análise
+    GraphAnalysis cachedAnalysis;
+    bool analysisValid = false;
+
+    PatrolStats lastPatrolStats;
+
+    // Rota memorizada de cada componente da análise atual, reaproveitada enquanto a componente e o seu
+    // vértice inicial não mudarem
+    struct CachedRoute {
+        bool valid = false;
+        uint32_t startNode = NO_VERTEX;
+        std::vector<uint32_t> route;
+        PatrolStats stats;
+    };
+    std::vector<CachedRoute> routeCache;
 
     // Métodos auxiliares
-    std::unordered_map<std::string, std::vector<std::string>> transposeGraph();
-    std::unordered_map<std::string, int> calculateBalance(const std::unordered_map<std::string, std::vector<std::string>>& subgraph);
-    std::unordered_map<std::string, std::vector<std::string>> generateSubgraph(const std::vector<std::string>& vertices);
-    int bfsDistance(const std::unordered_map<std::string, std::vector<std::string>>& graph, const std::string& source, const std::string& target);
-    void transformToEulerian(std::unordered_map<std::string, std::vector<std::string>>& subgraph, std::unordered_map<std::string, int>& balance);
-    std::vector<std::string> findEulerianCycleFromStart(const std::unordered_map<std::string, std::vector<std::string>>& subgraph, const std::string& startNode);
-    std::vector<std::string> findEulerianCycle(const std::unordered_map<std::string, std::vector<std::string>>& subgraph);
+    void materializeEdges();
+    const std::vector<uint32_t>& nameRanks();
+    void generateSubgraph(const CSRGraph& graph, const std::vector<uint32_t>& vertices,
+                          const GraphAnalysis& result, Subgraph& subgraph) const;
+    std::vector<std::string> toNames(const std::vector<uint32_t>& ids) const;
 };
 
 #endif // GRAPH_HPP
@@ -0,0 +1,112 @@
+#ifndef GRAPH_ANALYSIS_HPP
+#define GRAPH_ANALYSIS_HPP
+
+#include "CSRGraph.hpp"
+#include "CapitalFinder.hpp"
+#include "EulerianCycle.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Algoritmo usado na decomposição em componentes fortemente conectadas
+enum class SCCAlgorithm {
+    Kosaraju, // Duas DFS iterativas (lista direta e reversa)
+    Tarjan,   // Uma única DFS iterativa, sem percorrer o grafo transposto
+    Parallel  // Poda das componentes triviais e divisão forward-backward em várias threads
+};
+
+// Critério de posicionamento dos batalhões secundários
+enum class BattalionMode {
+    PerComponent,  // Um batalhão em cada componente sem a capital, no vértice mais próximo dela
+    SinkComponents // Só nas componentes sumidouro da condensação sem a capital, no vértice mais próximo dela: o
+                   // menor conjunto de batalhões tal que todo centro alcança a capital ou um batalhão
+};
+
+struct AnalysisOptions {
+    CapitalOptions capital;
+    SCCAlgorithm sccAlgorithm = SCCAlgorithm::Tarjan;
+    BattalionMode battalions = BattalionMode::PerComponent;
+    BalancingMode balancing = BalancingMode::MinCostFlow; // Usado pelas rotas de patrulhamento
+
+    // Limite de memória em bytes (0 = sem limite). Acima dele as rotas deixam de ser memorizadas e o
+    // balanceamento por emparelhamento cede ao fluxo de custo mínimo nas componentes cuja matriz não caberia
+    uint64_t memoryBudget = 0;
+};
+
+// Resultado da análise de um grafo congelado, calculado uma única vez e compartilhado pelas
+// três saídas do programa (capital, batalhões secundários e rotas de patrulhamento)
+struct GraphAnalysis {
+    // Capital escolhida (UINT32_MAX se nenhum vértice alcança todos) e distâncias a partir dela (em estradas,
+    // ou somando os pesos em grafos com pesos; UINT64_MAX nos vértices inalcançáveis)
+    uint32_t capital = UINT32_MAX;
+    std::vector<uint64_t> capitalDistances;
+
+    // Componentes fortemente conectadas e o rótulo de componente de cada vértice, em forma canônica:
+    // componentes numeradas pela ordem do seu menor vértice e membros em ordem crescente de identificador,
+    // de modo que todos os algoritmos de SCC produzam exatamente a mesma saída
+    std::vector<std::vector<uint32_t>> components;
+    std::vector<uint32_t> componentOf;
+
+    // Posição de cada vértice dentro da sua componente: o identificador local usado nos subgrafos
+    std::vector<uint32_t> localIndex;
+
+    // Grafo de condensação (um vértice por componente, arestas entre componentes sem repetição)
+    CSRGraph condensation;
+
+    // Batalhão secundário de cada componente sem a capital que recebe um, na ordem das componentes
+    // (UINT32_MAX se a componente é inalcançável)
+    std::vector<uint32_t> secondaryBattalions;
+
+    // Batalhão de cada componente, indexado pelo rótulo: a capital na componente dela e o batalhão secundário
+    // nas demais (UINT32_MAX se a componente não recebe batalhão ou é inalcançável)
+    std::vector<uint32_t> componentBattalion;
+
+    // Contadores da busca podada da capital
+    CapitalSearchStats capitalStats;
+
+    // Limite inferior da soma de distâncias de cada candidato na última busca podada (vazio nos outros modos),
+    // usado pelas atualizações incrementais para decidir se a capital precisa ser reavaliada
+    std::vector<uint64_t> capitalBounds;
+
+    // Se capitalDistances e capitalBounds foram calculados com pesos: um lote que remove a última estrada de
+    // peso diferente de 1 muda a métrica, e os valores anteriores deixam de servir de ponto de partida
+    bool weightedDistances = false;
+
+    // Executa toda a análise: SCCs, condensação, capital, distâncias da capital e batalhões
+    static GraphAnalysis compute(const CSRGraph& graph, const std::vector<std::string>& names,
+                                 const AnalysisOptions& options);
+
+    // Reconstrói a análise a partir dos rótulos canônicos de componente e das distâncias da capital já
+    // calculados (ex.: lidos de um snapshot), sem refazer a decomposição nem as buscas da capital
+    static GraphAnalysis restore(const CSRGraph& graph, const std::vector<std::string>& names,
+                                 std::vector<uint32_t> componentOf, uint32_t capital,
+                                 std::vector<uint64_t> capitalDistances, BattalionMode battalions);
+
+    // Decompõe o grafo em componentes com o algoritmo escolhido (numThreads vale apenas para o paralelo)
+    // e preenche components/componentOf na forma canônica
+    static void decompose(const CSRGraph& graph, SCCAlgorithm algorithm, unsigned numThreads,
+                          std::vector<std::vector<uint32_t>>& components, std::vector<uint32_t>& componentOf);
+
+    // Renumera rótulos arbitrários (menores que numLabels) na forma canônica e agrupa os membros
+    static void canonicalize(uint32_t numLabels, std::vector<uint32_t>& componentOf,
+                             std::vector<std::vector<uint32_t>>& components);
+
+    // Distâncias BFS a partir de uma origem; vértices inalcançáveis ficam com UINT64_MAX
+    static std::vector<uint64_t> bfsDistances(const CSRGraph& graph, uint32_t source);
+
+    // Distâncias a partir de uma origem: BFS sem pesos, caminhos mínimos (ShortestPaths) com pesos
+    static std::vector<uint64_t> distancesFrom(const CSRGraph& graph, uint32_t source, unsigned numThreads);
+
+    // Constrói o grafo de condensação a partir dos rótulos de componente
+    static CSRGraph buildCondensation(const CSRGraph& graph, const std::vector<std::vector<uint32_t>>& components,
+                                      const std::vector<uint32_t>& componentOf);
+
+private:
+    friend class IncrementalAnalysis;
+
+    // Condensação e índices locais a partir das componentes; batalhões a partir das distâncias da capital
+    void indexComponents(const CSRGraph& graph);
+    void placeBattalions(BattalionMode mode, const std::vector<std::string>& names);
+};
+
+#endif // GRAPH_ANALYSIS_HPP
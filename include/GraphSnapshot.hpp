@@ -0,0 +1,21 @@
+#ifndef GRAPH_SNAPSHOT_HPP
+#define GRAPH_SNAPSHOT_HPP
+
+#include "Graph.hpp"
+#include <string>
+
+// Snapshot binário versionado de um grafo já pré-processado: tabela de nomes, CSR direta e reversa (com os
+// pesos das estradas, se houver) e, opcionalmente, os rótulos de SCC e as distâncias da capital, com as opções
+// de análise que os produziram (só reaproveitados se a execução pedir as mesmas). A leitura mapeia o arquivo em
+// memória e usa os vetores da CSR no próprio mapeamento, sem interpretar texto nem reconstruir a CSR
+class GraphSnapshot {
+public:
+    // Grava o grafo em path (com a análise, se includeAnalysis); retorna false em erro de escrita
+    static bool write(const std::string& path, Graph& graph, bool includeAnalysis);
+
+    // Substitui o conteúdo de graph pelo snapshot; retorna false (sem alterar graph) se o arquivo não existir,
+    // for de outra versão ou ordem de bytes, estiver truncado ou falhar na soma de verificação
+    static bool load(const std::string& path, Graph& graph);
+};
+
+#endif // GRAPH_SNAPSHOT_HPP
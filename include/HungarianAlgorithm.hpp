@@ -1,13 +1,70 @@
 #ifndef HUNGARIAN_ALGORITHM_HPP
 #define HUNGARIAN_ALGORITHM_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <limits>
 
+// Matriz de custos densa, armazenada linha a linha em um único bloco contíguo
+struct CostMatrix {
+    size_t numRows = 0;
+    size_t numCols = 0;
+    std::vector<int> values;
+
+    CostMatrix() = default;
+    CostMatrix(size_t rows, size_t cols, int fill = 0) : numRows(rows), numCols(cols), values(rows * cols, fill) {}
+
+    int* row(size_t r) { return values.data() + r * numCols; }
+    const int* row(size_t r) const { return values.data() + r * numCols; }
+    int& operator()(size_t r, size_t c) { return values[r * numCols + c]; }
+    int operator()(size_t r, size_t c) const { return values[r * numCols + c]; }
+};
+
+// Matriz de custos esparsa em formato CSR: a linha r só pode ser emparelhada com as colunas
+// columns[rowOffsets[r] .. rowOffsets[r + 1]), cada uma com o custo correspondente em costs
+struct SparseCostMatrix {
+    size_t numRows = 0;
+    size_t numCols = 0;
+    std::vector<size_t> rowOffsets{0};
+    std::vector<uint32_t> columns;
+    std::vector<int> costs;
+
+    // Adiciona uma entrada à última linha aberta; endRow fecha a linha atual
+    void addEntry(uint32_t column, int cost) {
+        columns.push_back(column);
+        costs.push_back(cost);
+    }
+    void endRow() {
+        rowOffsets.push_back(columns.size());
+        ++numRows;
+    }
+};
+
 class HungarianAlgorithm {
 public:
-    // Resolve o problema de emparelhamento perfeito com base em uma matriz de custos
-    std::vector<int> solve(const std::vector<std::vector<int>>& costMatrix);
+    // Resolve o emparelhamento de custo mínimo: result[r] é a coluna atribuída à linha r (ou -1).
+    // Matrizes retangulares emparelham min(linhas, colunas) pares; matrizes vazias não geram pares
+    std::vector<int> solve(const CostMatrix& costMatrix);
+
+    // Considera apenas as entradas presentes na matriz esparsa; linhas sem caminho aumentante ficam com -1
+    std::vector<int> solve(const SparseCostMatrix& costMatrix);
+
+    // Mantém apenas as candidatesPerRow colunas mais baratas de cada linha
+    static SparseCostMatrix cheapestCandidates(const CostMatrix& costMatrix, size_t candidatesPerRow);
+
+private:
+    static constexpr int64_t INFINITE_COST = std::numeric_limits<int64_t>::max();
+
+    // Buffers reaproveitados entre as linhas e entre chamadas
+    std::vector<int64_t> rowPotential, colPotential, pathCost;
+    std::vector<int> colForRow, rowForCol, path;
+    std::vector<uint32_t> remaining, visitedRows, doneCols;
+    std::vector<char> done;
+
+    void resetDuals(size_t numRows, size_t numCols);
+    void updateDualsAndAugment(uint32_t currentRow, int64_t minValue, int sink);
+    std::vector<int> solveDense(const CostMatrix& costMatrix);
 };
 
 #endif // HUNGARIAN_ALGORITHM_HPP
@@ -0,0 +1,45 @@
+#ifndef INCREMENTAL_ANALYSIS_HPP
+#define INCREMENTAL_ANALYSIS_HPP
+
+#include "CSRGraph.hpp"
+#include "GraphAnalysis.hpp"
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Estradas inseridas e removidas por um lote de atualizações, já aplicadas ao grafo (por identificador)
+struct EdgeBatch {
+    std::vector<std::pair<uint32_t, uint32_t>> inserted;
+    std::vector<std::pair<uint32_t, uint32_t>> removed;
+};
+
+// Atualiza uma análise após um lote de alterações, refazendo apenas o que o lote pode afetar
+class IncrementalAnalysis {
+public:
+    // Recebe a análise do grafo anterior e o grafo já alterado (vértices novos recebem os próximos
+    // identificadores). Apenas as componentes que perderam estradas internas são decompostas de novo, e as
+    // fusões causadas por estradas novas são procuradas só na região alcançável a partir delas. As distâncias
+    // da capital são corrigidas apenas onde mudaram, e a capital só é reavaliada se o lote puder alterar a
+    // vencedora. previousComponent[c] recebe a componente anterior idêntica a c (mesmos vértices, nenhuma
+    // estrada interna alterada) ou UINT32_MAX
+    static GraphAnalysis update(const GraphAnalysis& previous, const CSRGraph& graph,
+                                const std::vector<std::string>& names, const AnalysisOptions& options,
+                                const EdgeBatch& batch, std::vector<uint32_t>& previousComponent);
+
+    // Corrige distâncias BFS a partir de source (válidas para o grafo antes do lote) para o grafo alterado:
+    // os vértices que perderam todos os predecessores em caminhos mínimos são recalculados, e as reduções
+    // causadas pelas estradas novas são propagadas a partir delas. Só vale sem pesos; com pesos, update
+    // recalcula as distâncias da capital por inteiro
+    static void updateDistances(const CSRGraph& graph, uint32_t source, const EdgeBatch& batch,
+                                std::vector<uint64_t>& distances);
+
+private:
+    static uint32_t relabelComponents(const GraphAnalysis& previous, const CSRGraph& graph, const EdgeBatch& batch,
+                                      std::vector<uint32_t>& componentOf);
+    static uint32_t chooseCapital(const GraphAnalysis& previous, GraphAnalysis& analysis, const CSRGraph& graph,
+                                  const std::vector<std::string>& names, const AnalysisOptions& options,
+                                  const EdgeBatch& batch);
+};
+
+#endif // INCREMENTAL_ANALYSIS_HPP
@@ -0,0 +1,94 @@
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+// Medição opcional das etapas do programa: tempo de relógio, tempo de CPU, alocações e pico de memória
+// residente de cada etapa, mais contadores dos algoritmos. Compilada apenas com GEOGRAPH_INSTRUMENTATION
+// (make INSTRUMENTATION=0 remove todas as medições e a contagem de alocações); mesmo compilada, só registra
+// algo depois de enable(), e até lá cada ponto de medição custa a leitura de um booleano
+class Instrumentation {
+public:
+    enum Counter {
+        BfsRuns,                     // BFS iniciadas (busca da capital e distâncias da capital)
+        BfsVerticesVisited,          // Vértices retirados da fila (ou expandidos, no modo bit-paralelo) nessas BFS
+        BfsEdgesScanned,             // Estradas examinadas nessas BFS
+        HungarianAugmentations,      // Caminhos aumentantes do Algoritmo Húngaro
+        FlowAugmentations,           // Caminhos aumentantes do fluxo de custo mínimo
+        EdgesDuplicated,             // Estradas duplicadas pelo balanceamento das rotas
+        HierholzerEdges,             // Estradas percorridas pelos ciclos Eulerianos
+        RoutesComputed,              // Rotas calculadas (as reaproveitadas do cache não contam)
+        ShortestPathRuns,            // Buscas de caminhos mínimos com pesos (Dijkstra ou delta-stepping)
+        ShortestPathVerticesSettled, // Vértices com distância final nessas buscas
+        ShortestPathEdgesScanned,    // Estradas examinadas nessas buscas
+        ArenaBytes,                  // Bytes servidos pelas arenas das rotas (sem passar pelo operador new)
+        CompactFallbacks,            // Etapas ou componentes que passaram ao modo compacto pelo limite de memória
+        NUM_COUNTERS
+    };
+
+    // Etapas do processo medem a CPU de todas as threads e as alocações; tarefas rodam dentro das threads de
+    // trabalho, medem a CPU da própria thread e são somadas entre todas as chamadas
+    enum class Scope { Process, Thread };
+
+    static void enable() { active.store(true, std::memory_order_relaxed); }
+    static bool enabled() { return active.load(std::memory_order_relaxed); }
+
+    static void add(Counter counter, uint64_t value) {
+        if (enabled()) {
+            counters[counter].fetch_add(value, std::memory_order_relaxed);
+        }
+    }
+
+    // Relatório em JSON, com as etapas na ordem em que começaram; destination "-" é a saída de erro.
+    // Retorna false se o arquivo não puder ser gravado
+    static void writeReport(std::ostream& out);
+    static bool writeReport(const std::string& destination);
+
+    // Mede o trecho entre a construção e a destruição; etapas com o mesmo nome são acumuladas
+    class Stage {
+    public:
+        explicit Stage(const char* name, Scope scope = Scope::Process);
+        ~Stage();
+
+        Stage(const Stage&) = delete;
+        Stage& operator=(const Stage&) = delete;
+
+    private:
+        Scope scope;
+        bool recording;
+        size_t record = 0; // Posição do registro acumulado desta etapa
+        uint64_t startWallNs;
+        uint64_t startCpuNs;
+        uint64_t startAllocations;
+        uint64_t startAllocatedBytes;
+        long startPeakRssKB;
+    };
+
+    // Alocações feitas desde o início do programa (contadas apenas com a medição ativa)
+    static std::atomic<uint64_t> allocations;
+    static std::atomic<uint64_t> allocatedBytes;
+
+private:
+    static std::atomic<bool> active;
+    static std::atomic<uint64_t> counters[NUM_COUNTERS];
+};
+
+#define INSTRUMENT_CONCAT_(a, b) a##b
+#define INSTRUMENT_CONCAT(a, b) INSTRUMENT_CONCAT_(a, b)
+
+#ifdef GEOGRAPH_INSTRUMENTATION
+#define INSTRUMENT_STAGE(name) Instrumentation::Stage INSTRUMENT_CONCAT(instrumentStage, __LINE__)(name)
+#define INSTRUMENT_TASK(name) \
+    Instrumentation::Stage INSTRUMENT_CONCAT(instrumentTask, __LINE__)(name, Instrumentation::Scope::Thread)
+#define INSTRUMENT_COUNT(counter, value) Instrumentation::add(Instrumentation::counter, (value))
+#else
+#define INSTRUMENT_STAGE(name) ((void)0)
+#define INSTRUMENT_TASK(name) ((void)0)
+#define INSTRUMENT_COUNT(counter, value) ((void)sizeof(value))
+#endif
+
+#endif // INSTRUMENTATION_HPP
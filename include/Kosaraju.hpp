@@ -1,19 +1,17 @@
 #ifndef KOSARAJU_HPP
 #define KOSARAJU_HPP
 
-#include <string>
+#include "CSRGraph.hpp"
+#include <cstdint>
 #include <vector>
-#include <unordered_map>
 
 class Kosaraju {
 public:
     // Encontra componentes fortemente conectadas em um grafo
-    static std::vector<std::vector<std::string>> findConnectedComponents(
-        const std::unordered_map<std::string, std::vector<std::string>>& adjacencyList);
+    static std::vector<std::vector<uint32_t>> findConnectedComponents(const CSRGraph& graph);
 
-    // Gera a transposição do grafo
-    static std::unordered_map<std::string, std::vector<std::string>> transposeGraph(
-        const std::unordered_map<std::string, std::vector<std::string>>& adjacencyList);
+    // Rotula cada vértice com sua componente (em ordem topológica da condensação) e retorna o número de componentes
+    static uint32_t labelComponents(const CSRGraph& graph, std::vector<uint32_t>& componentOf);
 };
 
 #endif // KOSARAJU_HPP
@@ -0,0 +1,59 @@
+#ifndef MEMORY_HPP
+#define MEMORY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+// Arena monotônica para os dados temporários de uma rodada de trabalho (ex.: o balanceamento e o ciclo de uma
+// componente), usada pelos contêineres std::pmr. Cada alocação só avança um ponteiro dentro do bloco atual e
+// liberar não faz nada; reset descarta a rodada inteira de uma vez e mantém os blocos para a próxima. Não é
+// thread-safe: cada thread usa a sua
+class Arena : public std::pmr::memory_resource {
+public:
+    Arena() = default;
+    ~Arena() override;
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // Descarta tudo o que foi alocado desde o último reset. Se a rodada precisou de mais de um bloco, eles viram
+    // um único bloco com a capacidade somada, para que a próxima rodada do mesmo tamanho caiba nele; acima de
+    // MAX_RETAINED os blocos são devolvidos, para que uma componente gigante não prenda a memória até o fim
+    void reset();
+
+    // Bytes entregues desde a criação (somando todas as rodadas)
+    uint64_t bytesServed() const { return served; }
+
+    static constexpr size_t FIRST_BLOCK = size_t(64) << 10;
+    static constexpr size_t MAX_RETAINED = size_t(16) << 20;
+
+private:
+    struct Block {
+        std::byte* data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks;
+    size_t used = 0; // Bytes ocupados no último bloco
+    uint64_t served = 0;
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    void releaseBlocks();
+};
+
+// Limite de memória da análise (--memory-budget): as etapas grandes consultam o limite antes de escolher
+// entre o modo normal e um modo mais compacto
+class MemoryBudget {
+public:
+    // Memória residente atual do processo, em bytes (o pico, se a atual não puder ser lida)
+    static uint64_t residentBytes();
+
+    // Se mais bytes ainda cabem no limite junto com a memória residente atual (budget 0 = sem limite)
+    static bool fits(uint64_t budget, uint64_t bytes) { return budget == 0 || residentBytes() + bytes <= budget; }
+};
+
+#endif // MEMORY_HPP
@@ -0,0 +1,37 @@
+#ifndef MIN_COST_FLOW_HPP
+#define MIN_COST_FLOW_HPP
+
+#include <cstdint>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+// Fluxo de custo mínimo por caminhos aumentantes sucessivos, com potenciais nos vértices para que cada
+// caminho mínimo no grafo residual seja calculado por Dijkstra (custos dos arcos devem ser não negativos).
+// Os arcos, as listas de saída e os buffers do solve vêm de memory (ex.: a Arena da thread)
+class MinCostFlow {
+public:
+    explicit MinCostFlow(uint32_t numNodes, std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    // Adiciona um arco com capacidade e custo por unidade; retorna o índice do arco
+    uint32_t addArc(uint32_t from, uint32_t to, int64_t capacity, int64_t cost);
+
+    // Envia até maxFlow unidades de source para sink pelo menor custo total; retorna {fluxo, custo}
+    std::pair<int64_t, int64_t> solve(uint32_t source, uint32_t sink, int64_t maxFlow);
+
+    // Fluxo que passa pelo arco após solve
+    int64_t flow(uint32_t arc) const { return arcs[arc ^ 1].capacity; }
+
+private:
+    // Arcos guardados aos pares: o arco 2i é o original e 2i + 1 é o seu reverso residual
+    struct Arc {
+        uint32_t to;
+        int64_t capacity;
+        int64_t cost;
+    };
+
+    std::pmr::vector<Arc> arcs;
+    std::pmr::vector<std::pmr::vector<uint32_t>> outArcs;
+};
+
+#endif // MIN_COST_FLOW_HPP
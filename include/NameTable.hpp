@@ -0,0 +1,43 @@
+#ifndef NAME_TABLE_HPP
+#define NAME_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Tabela hash de endereçamento aberto (sondagem linear) que associa nomes a identificadores densos.
+// Os nomes ficam no vetor externo names (names[id]); cada posição guarda apenas o hash e o identificador,
+// então a busca por string_view não aloca e a tabela não duplica as strings
+class NameTable {
+public:
+    static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+
+    // Identificador do nome, ou NOT_FOUND se ele ainda não foi internado
+    uint32_t find(std::string_view name, const std::vector<std::string>& names) const;
+
+    // Retorna o identificador do nome, acrescentando-o ao final de names caso ainda não exista
+    uint32_t intern(std::string_view name, std::vector<std::string>& names);
+
+    // Refaz a tabela para nomes já presentes em names (distintos), com identificadores iguais às posições
+    void rebuild(const std::vector<std::string>& names);
+
+    // Prepara a tabela para receber count nomes sem redimensionar
+    void reserve(size_t count);
+
+private:
+    struct Slot {
+        uint32_t hash;
+        uint32_t id = NOT_FOUND;
+    };
+
+    std::vector<Slot> slots; // Tamanho sempre potência de 2 (ou zero)
+    size_t numEntries = 0;
+
+    static uint32_t hashOf(std::string_view name);
+    size_t findSlot(std::string_view name, uint32_t hash, const std::vector<std::string>& names) const;
+    void rehash(size_t capacity);
+};
+
+#endif // NAME_TABLE_HPP
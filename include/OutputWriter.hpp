@@ -0,0 +1,47 @@
+#ifndef OUTPUT_WRITER_HPP
+#define OUTPUT_WRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Saída bufferizada direto em um descritor de arquivo, sem passar por iostream e sem flush por linha.
+// Os bytes são copiados do chamador (ex.: da tabela de nomes internados) para um buffer grande, esvaziado
+// com write quando enche; trechos maiores que o buffer vão junto com o conteúdo pendente em um único writev,
+// sem cópia. Não é thread-safe: quem escreve de várias threads precisa serializar as chamadas
+class OutputWriter {
+public:
+    explicit OutputWriter(int fd, size_t capacity = DEFAULT_CAPACITY);
+    ~OutputWriter(); // Esvazia o buffer (erros só são vistos por flush/good)
+
+    OutputWriter(const OutputWriter&) = delete;
+    OutputWriter& operator=(const OutputWriter&) = delete;
+
+    void write(std::string_view bytes);
+    void put(char byte) {
+        if (used == buffer.size()) {
+            drain();
+        }
+        buffer[used++] = byte;
+    }
+    void writeNumber(uint64_t value);  // Decimal
+    void writeVarint(uint64_t value);  // LEB128: 7 bits por byte, bit alto indica continuação
+
+    // Envia tudo o que está pendente; retorna false se alguma escrita falhou desde a criação
+    bool flush();
+    bool good() const { return !failed; }
+
+    static constexpr size_t DEFAULT_CAPACITY = size_t(1) << 20;
+
+private:
+    int fd;
+    std::vector<char> buffer;
+    size_t used = 0;
+    bool failed = false;
+
+    void drain();
+    void writeAll(const char* data, size_t size);
+};
+
+#endif // OUTPUT_WRITER_HPP
@@ -0,0 +1,59 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Resolve o número de threads a usar: 0 significa "todas as disponíveis na máquina"
+inline unsigned resolveThreadCount(unsigned requested) {
+    if (requested != 0) {
+        return requested;
+    }
+    unsigned available = std::thread::hardware_concurrency();
+    return available == 0 ? 1 : available;
+}
+
+// Executa body(threadIndex, begin, end) sobre o intervalo [0, count), distribuindo blocos de
+// chunkSize itens dinamicamente entre as threads. Com uma única thread (ou um único bloco)
+// o trabalho é executado na thread chamadora, sem criar threads.
+template <typename Body>
+void parallelFor(unsigned numThreads, size_t count, size_t chunkSize, Body body) {
+    if (count == 0) {
+        return;
+    }
+    chunkSize = std::max<size_t>(chunkSize, 1);
+    size_t numChunks = (count + chunkSize - 1) / chunkSize;
+    unsigned workers = static_cast<unsigned>(std::min<size_t>(resolveThreadCount(numThreads), numChunks));
+
+    if (workers <= 1) {
+        body(0u, size_t(0), count);
+        return;
+    }
+
+    std::atomic<size_t> nextChunk{0};
+    auto worker = [&](unsigned threadIndex) {
+        for (;;) {
+            size_t chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= numChunks) {
+                break;
+            }
+            size_t begin = chunk * chunkSize;
+            body(threadIndex, begin, std::min(begin + chunkSize, count));
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (unsigned t = 1; t < workers; ++t) {
+        threads.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+#endif // PARALLEL_HPP
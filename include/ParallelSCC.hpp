@@ -0,0 +1,18 @@
+#ifndef PARALLEL_SCC_HPP
+#define PARALLEL_SCC_HPP
+
+#include "CSRGraph.hpp"
+#include <cstdint>
+#include <vector>
+
+class ParallelSCC {
+public:
+    // Encontra componentes fortemente conectadas usando várias threads (0 = todas as disponíveis)
+    static std::vector<std::vector<uint32_t>> findConnectedComponents(const CSRGraph& graph, unsigned numThreads);
+
+    // Rotula cada vértice com sua componente e retorna o número de componentes. Os rótulos dependem do
+    // escalonamento das threads; a ordem canônica é obtida em GraphAnalysis::decompose
+    static uint32_t labelComponents(const CSRGraph& graph, unsigned numThreads, std::vector<uint32_t>& componentOf);
+};
+
+#endif // PARALLEL_SCC_HPP
@@ -0,0 +1,61 @@
+#ifndef QUERY_SERVER_HPP
+#define QUERY_SERVER_HPP
+
+#include "Graph.hpp"
+#include <atomic>
+#include <iosfwd>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+// Servidor de consultas sobre um grafo carregado uma única vez. Protocolo de linhas:
+//   capital                  -> a capital
+//   battalions               -> os batalhões secundários, um por linha
+//   route CENTRO             -> a rota de patrulhamento da componente do centro (nenhuma linha se não houver)
+//   distance ORIGEM DESTINO  -> o comprimento do menor caminho, em estradas ou somando os pesos (-1 se não houver)
+//   update + A B [P] - C D   -> aplica o lote de inserções (+, com peso P opcional) e remoções (-) e responde
+//                               quantas valeram
+//   quit                     -> encerra a conexão; shutdown encerra também o servidor de socket
+// Cada resposta começa com "OK n", seguida de n linhas, ou é uma única linha "ERR mensagem".
+// As consultas de leitura rodam em paralelo sob um lock compartilhado e usam apenas respostas e estruturas
+// preparadas após a carga e após cada atualização; as atualizações tomam o lock exclusivo
+class QueryServer {
+public:
+    explicit QueryServer(Graph& graph);
+
+    // Responde a uma requisição; pode ser chamada por várias threads ao mesmo tempo
+    std::string handle(const std::string& request);
+
+    // Atende requisições linha a linha até o fim da entrada ou "quit"
+    void serveStream(std::istream& in, std::ostream& out);
+
+    // Atende conexões em um socket Unix local, uma thread por conexão, até "shutdown";
+    // retorna false se o socket não puder ser criado
+    bool serveSocket(const std::string& path);
+
+private:
+    Graph& graph;
+    std::shared_mutex mutex;
+
+    // Estado preparado por refresh (sob o lock exclusivo) e só lido pelas consultas
+    const CSRGraph* frozen = nullptr;
+    const GraphAnalysis* analysis = nullptr;
+    std::string capitalResponse;
+    std::string battalionsResponse;
+    std::vector<std::string> routeResponse; // Por componente
+
+    // Servidor de socket: descritor de escuta e conexões abertas, fechados no shutdown
+    std::atomic<bool> stopping{false};
+    int listenFd = -1;
+    std::mutex connectionsMutex;
+    std::vector<int> connections;
+
+    void refresh();
+    std::string distance(const std::string& from, const std::string& to) const;
+    std::string update(std::istream& fields);
+    void serveConnection(int fd);
+    void stop();
+};
+
+#endif // QUERY_SERVER_HPP
@@ -0,0 +1,61 @@
+#ifndef SHORTEST_PATHS_HPP
+#define SHORTEST_PATHS_HPP
+
+#include "CSRGraph.hpp"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Fila de prioridade monótona (radix heap) para o Dijkstra: as chaves retiradas nunca diminuem, então cada
+// entrada fica no balde do bit mais alto em que difere da última chave retirada e só desce de balde, com
+// custo amortizado O(log C) por entrada e sem comparações entre entradas
+class RadixHeap {
+public:
+    // key não pode ser menor que a última chave retirada
+    void push(uint64_t key, uint32_t vertex) {
+        buckets[bucketOf(key)].emplace_back(key, vertex);
+        ++count;
+    }
+
+    // Retira uma entrada de menor chave (a fila não pode estar vazia)
+    std::pair<uint64_t, uint32_t> pop();
+
+    bool empty() const { return count == 0; }
+    void clear();
+
+private:
+    static constexpr unsigned NUM_BUCKETS = 65; // Balde 0 para a própria última chave e um por bit
+
+    std::vector<std::pair<uint64_t, uint32_t>> buckets[NUM_BUCKETS];
+    uint64_t last = 0;
+    size_t count = 0;
+
+    unsigned bucketOf(uint64_t key) const {
+        return key == last ? 0 : 64 - static_cast<unsigned>(__builtin_clzll(key ^ last));
+    }
+};
+
+// Caminhos mínimos com pesos nas estradas (grafos com CSRGraph::weighted()); distâncias em 64 bits
+class ShortestPaths {
+public:
+    // Distância dos vértices inalcançáveis
+    static constexpr uint64_t UNREACHABLE = UINT64_MAX;
+
+    // A partir deste número de vértices, com mais de uma thread, a origem única usa o delta-stepping
+    static constexpr uint32_t PARALLEL_THRESHOLD = 1u << 16;
+
+    // Dijkstra com radix heap, reaproveitando os buffers distances e heap; retorna quantos vértices alcançou
+    static uint32_t dijkstra(const CSRGraph& graph, uint32_t source, std::vector<uint64_t>& distances,
+                             RadixHeap& heap);
+
+    // Delta-stepping: baldes de largura delta processados em ordem; dentro de um balde as estradas leves
+    // (peso <= delta) são relaxadas em paralelo até o balde esvaziar, e as pesadas uma única vez ao final.
+    // delta = 0 usa o peso médio das estradas
+    static std::vector<uint64_t> deltaStepping(const CSRGraph& graph, uint32_t source, unsigned numThreads,
+                                               uint64_t delta = 0);
+
+    // Distâncias de uma origem: delta-stepping em grafos grandes com várias threads, Dijkstra nos demais
+    static std::vector<uint64_t> distancesFrom(const CSRGraph& graph, uint32_t source, unsigned numThreads);
+};
+
+#endif // SHORTEST_PATHS_HPP
@@ -0,0 +1,110 @@
+#ifndef TARJAN_HPP
+#define TARJAN_HPP
+
+#include "CSRGraph.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+class Tarjan {
+public:
+    static constexpr uint32_t OUTSIDE = UINT32_MAX;
+
+    // Arrays e pilhas da DFS iterativa, indexados pela posição do vértice no subconjunto e reaproveitados
+    // entre chamadas (um por thread)
+    struct Workspace {
+        std::vector<uint32_t> index;
+        std::vector<uint32_t> lowLink;
+        std::vector<uint32_t> nextEdge;
+        std::vector<char> onStack;
+        std::vector<uint32_t> callStack;
+        std::vector<uint32_t> componentStack;
+    };
+
+    // Encontra componentes fortemente conectadas em um grafo, em uma única passada
+    static std::vector<std::vector<uint32_t>> findConnectedComponents(const CSRGraph& graph);
+
+    // Rotula cada vértice com sua componente (em ordem topológica reversa) e retorna o número de componentes
+    static uint32_t labelComponents(const CSRGraph& graph, std::vector<uint32_t>& componentOf);
+
+    // Rotula apenas os vértices de vertices, considerando só as arestas entre eles, com rótulos a partir de
+    // firstLabel; retorna o próximo rótulo livre. position é um vetor auxiliar com numVertices posições
+    // iguais a UINT32_MAX, restaurado ao final, para que o custo dependa só do subconjunto e das suas arestas
+    static uint32_t labelSubset(const CSRGraph& graph, const std::vector<uint32_t>& vertices, uint32_t firstLabel,
+                                std::vector<uint32_t>& componentOf, std::vector<uint32_t>& position);
+
+    // DFS iterativa de Tarjan restrita a um subconjunto numerado de 0 a size - 1, usada por todas as variantes:
+    // vertexAt(i) é o vértice da posição i e slotOf(v) a posição de v, ou OUTSIDE se v não pertence ao
+    // subconjunto (a aresta é ignorada). As raízes são tomadas na ordem das posições, e cada componente fechada
+    // é entregue a emit(begin, end) com as posições dos seus membros, em ordem topológica reversa
+    template <typename VertexAt, typename SlotOf, typename Emit>
+    static void labelRestricted(const CSRGraph& graph, uint32_t size, VertexAt vertexAt, SlotOf slotOf, Emit emit,
+                                Workspace& workspace) {
+        std::vector<uint32_t>& index = workspace.index;
+        std::vector<uint32_t>& lowLink = workspace.lowLink;
+        std::vector<uint32_t>& nextEdge = workspace.nextEdge;
+        std::vector<char>& onStack = workspace.onStack;
+        std::vector<uint32_t>& callStack = workspace.callStack;
+        std::vector<uint32_t>& componentStack = workspace.componentStack;
+        index.assign(size, OUTSIDE);
+        lowLink.assign(size, 0);
+        nextEdge.assign(size, 0);
+        onStack.assign(size, false);
+        callStack.reserve(size);
+        componentStack.reserve(size);
+
+        uint32_t counter = 0;
+        for (uint32_t root = 0; root < size; ++root) {
+            if (index[root] != OUTSIDE) {
+                continue;
+            }
+            index[root] = lowLink[root] = counter++;
+            componentStack.push_back(root);
+            onStack[root] = true;
+            callStack.push_back(root);
+
+            while (!callStack.empty()) {
+                const uint32_t node = callStack.back();
+                const NeighborRange neighbors = graph.neighbors(vertexAt(node));
+
+                if (nextEdge[node] < neighbors.size()) {
+                    const uint32_t neighbor = slotOf(neighbors.first[nextEdge[node]++]);
+                    if (neighbor == OUTSIDE) {
+                        continue; // Aresta para fora do subconjunto
+                    }
+                    if (index[neighbor] == OUTSIDE) {
+                        // Desce para o vizinho, simulando a chamada recursiva
+                        index[neighbor] = lowLink[neighbor] = counter++;
+                        componentStack.push_back(neighbor);
+                        onStack[neighbor] = true;
+                        callStack.push_back(neighbor);
+                    } else if (onStack[neighbor]) {
+                        lowLink[node] = std::min(lowLink[node], index[neighbor]);
+                    }
+                    continue;
+                }
+
+                // Todos os vizinhos explorados: fecha a componente se o nó for sua raiz (os membros são o topo
+                // da pilha de componentes até ele)
+                if (lowLink[node] == index[node]) {
+                    size_t first = componentStack.size();
+                    do {
+                        --first;
+                        onStack[componentStack[first]] = false;
+                    } while (componentStack[first] != node);
+                    emit(componentStack.data() + first, componentStack.data() + componentStack.size());
+                    componentStack.resize(first);
+                }
+
+                // Retorna ao chamador, propagando o menor índice alcançável
+                callStack.pop_back();
+                if (!callStack.empty()) {
+                    const uint32_t parent = callStack.back();
+                    lowLink[parent] = std::min(lowLink[parent], lowLink[node]);
+                }
+            }
+        }
+    }
+};
+
+#endif // TARJAN_HPP
@@ -0,0 +1,72 @@
+#include "../include/BreadthFirstSearch.hpp"
+
+// Começa uma busca: só os buffers de outro tamanho são realocados, e a nova época invalida as marcas antigas
+void BreadthFirstSearch::start(const CSRGraph& graph, uint32_t source) {
+    const uint32_t numVertices = graph.numVertices();
+    if (marks.size() != numVertices) {
+        marks.assign(numVertices, Mark());
+        frontierBits.assign((numVertices + 63) / 64, 0);
+        order.reserve(numVertices);
+        epoch = 0;
+    }
+    if (++epoch == 0) { // Após 2^32 buscas as marcas antigas voltariam a valer
+        marks.assign(numVertices, Mark());
+        epoch = 1;
+    }
+    order.clear();
+    bottomUp = false;
+    unexploredEdges = graph.numEdges();
+
+    marks[source] = {epoch, 0};
+    order.push_back(source);
+}
+
+// Descobre o nível depth + 1 a partir dos vértices order[begin, end) do nível depth
+void BreadthFirstSearch::expand(const CSRGraph& graph, Direction direction, uint32_t depth, size_t begin,
+                                size_t end) {
+    const bool forward = direction == Direction::Forward;
+    uint64_t frontierEdges = 0;
+    for (size_t i = begin; i < end; ++i) {
+        frontierEdges += forward ? graph.outDegree(order[i]) : graph.inDegree(order[i]);
+    }
+    if (bottomUp) {
+        bottomUp = (end - begin) * BETA >= graph.numVertices();
+    } else {
+        bottomUp = frontierEdges * ALPHA > unexploredEdges;
+    }
+    unexploredEdges -= frontierEdges;
+
+    if (!bottomUp) {
+        for (size_t i = begin; i < end; ++i) {
+            const uint32_t node = order[i];
+            for (uint32_t neighbor : forward ? graph.neighbors(node) : graph.reverseNeighbors(node)) {
+                if (marks[neighbor].epoch != epoch) {
+                    marks[neighbor] = {epoch, depth + 1};
+                    order.push_back(neighbor);
+                }
+            }
+        }
+        scanned += frontierEdges;
+        return;
+    }
+
+    for (size_t i = begin; i < end; ++i) {
+        frontierBits[order[i] >> 6] |= uint64_t(1) << (order[i] & 63);
+    }
+    for (uint32_t node = 0; node < graph.numVertices(); ++node) {
+        if (marks[node].epoch == epoch) {
+            continue;
+        }
+        for (uint32_t predecessor : forward ? graph.reverseNeighbors(node) : graph.neighbors(node)) {
+            ++scanned;
+            if (frontierBits[predecessor >> 6] >> (predecessor & 63) & 1) {
+                marks[node] = {epoch, depth + 1};
+                order.push_back(node);
+                break;
+            }
+        }
+    }
+    for (size_t i = begin; i < end; ++i) {
+        frontierBits[order[i] >> 6] = 0;
+    }
+}
@@ -0,0 +1,78 @@
+#include "../include/CSRGraph.hpp"
+#include <utility>
+
+// Constrói as listas direta e reversa a partir da lista de arestas (contagem, soma de prefixos e preenchimento)
+CSRGraph::CSRGraph(uint32_t numVertices, const std::vector<std::pair<uint32_t, uint32_t>>& edges,
+                   const std::vector<uint32_t>& edgeWeights)
+    : vertexCount(numVertices),
+      edgeCount(edges.size()),
+      offsets(numVertices + 1, 0),
+      targets(edges.size()),
+      reverseOffsets(numVertices + 1, 0),
+      reverseTargets(edges.size()),
+      weights(edgeWeights.empty() ? 0 : edges.size()) {
+
+    // Passo 1: Conta os graus de saída e de entrada
+    for (const auto& edge : edges) {
+        offsets[edge.first + 1]++;
+        reverseOffsets[edge.second + 1]++;
+    }
+
+    // Passo 2: Converte as contagens em deslocamentos
+    for (uint32_t v = 0; v < numVertices; ++v) {
+        offsets[v + 1] += offsets[v];
+        reverseOffsets[v + 1] += reverseOffsets[v];
+    }
+
+    // Passo 3: Preenche os destinos mantendo a ordem de inserção de cada vértice
+    std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    std::vector<uint32_t> reverseCursor(reverseOffsets.begin(), reverseOffsets.end() - 1);
+    for (size_t i = 0; i < edges.size(); ++i) {
+        const auto& edge = edges[i];
+        if (!weights.empty()) {
+            weights[cursor[edge.first]] = edgeWeights[i];
+        }
+        targets[cursor[edge.first]++] = edge.second;
+        reverseTargets[reverseCursor[edge.second]++] = edge.first;
+    }
+    bindStorage();
+}
+
+// Aponta os vetores em uso para os vetores próprios
+void CSRGraph::bindStorage() {
+    data = {offsets.data(), targets.data(), reverseOffsets.data(), reverseTargets.data(),
+            weights.empty() ? nullptr : weights.data()};
+}
+
+CSRGraph CSRGraph::view(uint32_t numVertices, size_t numEdges, const CSRArrays& arrays,
+                        std::shared_ptr<const void> owner) {
+    CSRGraph graph;
+    graph.vertexCount = numVertices;
+    graph.edgeCount = numEdges;
+    graph.data = arrays;
+    graph.external = std::move(owner);
+    return graph;
+}
+
+CSRGraph::CSRGraph(const CSRGraph& other)
+    : vertexCount(other.vertexCount),
+      edgeCount(other.edgeCount),
+      data(other.data),
+      external(other.external),
+      offsets(other.offsets),
+      targets(other.targets),
+      reverseOffsets(other.reverseOffsets),
+      reverseTargets(other.reverseTargets),
+      weights(other.weights) {
+    if (!external) {
+        bindStorage();
+    }
+}
+
+CSRGraph& CSRGraph::operator=(const CSRGraph& other) {
+    if (this != &other) {
+        CSRGraph copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
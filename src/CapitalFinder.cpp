@@ -0,0 +1,644 @@
+#include "../include/CapitalFinder.hpp"
+#include "../include/BreadthFirstSearch.hpp"
+#include "../include/Kosaraju.hpp"
+#include "../include/Parallel.hpp"
+#include "../include/ShortestPaths.hpp"
+#include "../include/Instrumentation.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <random>
+
+// Número de origens processadas por passada no modo bit-paralelo (uma por bit da palavra)
+static constexpr uint32_t SOURCES_PER_WORD = 64;
+
+// Semente fixa do sorteio dos pivôs, para que o modo aproximado seja reproduzível
+static constexpr uint64_t APPROXIMATION_SEED = 0x9e3779b97f4a7c15ULL;
+
+// BFS completa a partir de source; retorna a soma das distâncias, acumulada nível a nível
+static uint64_t breadthFirstSum(BreadthFirstSearch& bfs, const CSRGraph& graph, uint32_t source) {
+    uint64_t totalDistance = 0;
+    auto addLevel = [&totalDistance](uint32_t depth, const uint32_t* begin, const uint32_t* end) {
+        totalDistance += static_cast<uint64_t>(depth) * static_cast<uint64_t>(end - begin);
+        return true;
+    };
+    bfs.run(graph, source, BreadthFirstSearch::Direction::Forward, addLevel);
+    return totalDistance;
+}
+
+// Calcula as somas de distâncias com uma BFS por origem, reaproveitando os buffers de cada thread
+void CapitalFinder::sumsBySingleSourceBFS(const CSRGraph& graph, unsigned numThreads, std::vector<uint64_t>& sums) {
+    const uint32_t numVertices = graph.numVertices();
+    const unsigned workers = resolveThreadCount(numThreads);
+
+    std::vector<BreadthFirstSearch> searches(workers);
+
+    parallelFor(workers, numVertices, 16, [&](unsigned thread, size_t begin, size_t end) {
+        BreadthFirstSearch& bfs = searches[thread];
+        const uint64_t scannedBefore = bfs.edgesScanned();
+        uint64_t verticesVisited = 0;
+
+        for (size_t start = begin; start < end; ++start) {
+            const uint64_t totalDistance = breadthFirstSum(bfs, graph, static_cast<uint32_t>(start));
+            sums[start] = bfs.visited().size() == numVertices ? totalDistance : UNREACHABLE;
+            verticesVisited += bfs.visited().size();
+        }
+        const uint64_t edgesScanned = bfs.edgesScanned() - scannedBefore;
+        INSTRUMENT_COUNT(BfsRuns, end - begin);
+        INSTRUMENT_COUNT(BfsVerticesVisited, verticesVisited);
+        INSTRUMENT_COUNT(BfsEdgesScanned, edgesScanned);
+    });
+}
+
+// Calcula as somas de distâncias processando 64 origens por passada: cada vértice guarda uma
+// máscara com as origens que já o visitaram e outra com as que o alcançaram no nível atual
+void CapitalFinder::sumsByBitParallelBFS(const CSRGraph& graph, unsigned numThreads, std::vector<uint64_t>& sums) {
+    const uint32_t numVertices = graph.numVertices();
+    const unsigned workers = resolveThreadCount(numThreads);
+    const size_t numBatches = (numVertices + SOURCES_PER_WORD - 1) / SOURCES_PER_WORD;
+
+    struct Scratch {
+        std::vector<uint64_t> visited, frontier, next;
+        std::vector<uint32_t> active, touched;
+    };
+    std::vector<Scratch> scratchBuffers(workers);
+
+    parallelFor(workers, numBatches, 1, [&](unsigned thread, size_t batchBegin, size_t batchEnd) {
+        Scratch& scratch = scratchBuffers[thread];
+        scratch.visited.assign(numVertices, 0);
+        scratch.frontier.assign(numVertices, 0);
+        scratch.next.assign(numVertices, 0);
+        uint64_t sources = 0, verticesExpanded = 0, edgesScanned = 0;
+
+        for (size_t batch = batchBegin; batch < batchEnd; ++batch) {
+            const uint32_t firstSource = static_cast<uint32_t>(batch * SOURCES_PER_WORD);
+            const uint32_t numSources = std::min<uint32_t>(SOURCES_PER_WORD, numVertices - firstSource);
+
+            uint64_t totals[SOURCES_PER_WORD] = {};
+            uint32_t reached[SOURCES_PER_WORD] = {};
+
+            // Nível 0: cada origem visita a si mesma
+            scratch.active.clear();
+            for (uint32_t bit = 0; bit < numSources; ++bit) {
+                uint32_t source = firstSource + bit;
+                scratch.visited[source] = uint64_t(1) << bit;
+                scratch.frontier[source] = uint64_t(1) << bit;
+                scratch.active.push_back(source);
+                reached[bit] = 1;
+            }
+
+            for (uint64_t level = 1; !scratch.active.empty(); ++level) {
+                // Propaga as máscaras da fronteira para os vizinhos (modo push)
+                scratch.touched.clear();
+                verticesExpanded += scratch.active.size();
+                for (uint32_t current : scratch.active) {
+                    uint64_t mask = scratch.frontier[current];
+                    edgesScanned += graph.outDegree(current);
+                    for (uint32_t neighbor : graph.neighbors(current)) {
+                        uint64_t fresh = mask & ~scratch.visited[neighbor];
+                        if (fresh != 0) {
+                            if (scratch.next[neighbor] == 0) {
+                                scratch.touched.push_back(neighbor);
+                            }
+                            scratch.next[neighbor] |= fresh;
+                        }
+                    }
+                    scratch.frontier[current] = 0;
+                }
+
+                // Consolida o novo nível e acumula as distâncias de cada origem
+                scratch.active.swap(scratch.touched);
+                for (uint32_t vertex : scratch.active) {
+                    uint64_t fresh = scratch.next[vertex];
+                    scratch.next[vertex] = 0;
+                    scratch.visited[vertex] |= fresh;
+                    scratch.frontier[vertex] = fresh;
+                    while (fresh != 0) {
+                        unsigned bit = static_cast<unsigned>(__builtin_ctzll(fresh));
+                        totals[bit] += level;
+                        reached[bit]++;
+                        fresh &= fresh - 1;
+                    }
+                }
+            }
+
+            for (uint32_t bit = 0; bit < numSources; ++bit) {
+                sums[firstSource + bit] = reached[bit] == numVertices ? totals[bit] : UNREACHABLE;
+            }
+
+            // Limpa as máscaras de visitados para o próximo lote de origens
+            std::fill(scratch.visited.begin(), scratch.visited.end(), 0);
+            sources += numSources;
+        }
+        INSTRUMENT_COUNT(BfsRuns, sources);
+        INSTRUMENT_COUNT(BfsVerticesVisited, verticesExpanded);
+        INSTRUMENT_COUNT(BfsEdgesScanned, edgesScanned);
+    });
+}
+
+// Calcula as somas de distâncias com pesos: um Dijkstra por origem, com a distância e a radix heap de cada
+// thread reaproveitadas entre as origens
+void CapitalFinder::sumsByDijkstra(const CSRGraph& graph, unsigned numThreads, std::vector<uint64_t>& sums) {
+    const uint32_t numVertices = graph.numVertices();
+    const unsigned workers = resolveThreadCount(numThreads);
+
+    std::vector<std::vector<uint64_t>> distanceBuffers(workers);
+    std::vector<RadixHeap> heaps(workers);
+
+    parallelFor(workers, numVertices, 16, [&](unsigned thread, size_t begin, size_t end) {
+        std::vector<uint64_t>& distances = distanceBuffers[thread];
+        for (size_t start = begin; start < end; ++start) {
+            const uint32_t source = static_cast<uint32_t>(start);
+            if (ShortestPaths::dijkstra(graph, source, distances, heaps[thread]) != numVertices) {
+                sums[source] = UNREACHABLE;
+                continue;
+            }
+            uint64_t totalDistance = 0;
+            for (uint64_t distance : distances) {
+                totalDistance += distance;
+            }
+            sums[source] = totalDistance;
+        }
+    });
+}
+
+// Calcula as somas de distâncias de todas as origens segundo a estratégia escolhida
+std::vector<uint64_t> CapitalFinder::computeDistanceSums(const CSRGraph& graph, const CapitalOptions& options) {
+    std::vector<uint64_t> sums(graph.numVertices(), UNREACHABLE);
+
+    if (graph.weighted()) {
+        const bool parallel = options.mode == CapitalMode::Parallel || options.mode == CapitalMode::BitParallel;
+        sumsByDijkstra(graph, parallel ? options.numThreads : 1, sums);
+        return sums;
+    }
+
+    switch (options.mode) {
+        case CapitalMode::Sequential:
+            sumsBySingleSourceBFS(graph, 1, sums);
+            break;
+        case CapitalMode::Parallel:
+            sumsBySingleSourceBFS(graph, options.numThreads, sums);
+            break;
+        case CapitalMode::BitParallel:
+            sumsByBitParallelBFS(graph, options.numThreads, sums);
+            break;
+        case CapitalMode::Pruned:
+        case CapitalMode::Approximate:
+            // As buscas podada e aproximada não calculam todas as somas; usa o caminho exato sequencial
+            sumsBySingleSourceBFS(graph, 1, sums);
+            break;
+    }
+    return sums;
+}
+
+// Encontra a capital como o nó que minimiza a soma das distâncias para todos os outros
+uint32_t CapitalFinder::findCapital(const CSRGraph& graph, const std::vector<std::string>& names,
+                                    const CapitalOptions& options, CapitalSearchStats* stats) {
+    if (options.mode == CapitalMode::Pruned) {
+        return findCapitalPruned(graph, names, stats);
+    }
+    if (options.mode == CapitalMode::Approximate) {
+        auto components = Kosaraju::findConnectedComponents(graph);
+        std::vector<uint32_t> componentOf(graph.numVertices());
+        for (uint32_t c = 0; c < components.size(); ++c) {
+            for (uint32_t node : components[c]) {
+                componentOf[node] = c;
+            }
+        }
+        return findCapitalApproximate(graph, names, components, componentOf, options, stats);
+    }
+
+    std::vector<uint64_t> sums = computeDistanceSums(graph, options);
+
+    // Redução sequencial, garantindo o mesmo desempate independentemente do número de threads
+    uint32_t bestNode = std::numeric_limits<uint32_t>::max();
+    for (uint32_t node = 0; node < graph.numVertices(); ++node) {
+        if (sums[node] == UNREACHABLE) {
+            continue;
+        }
+        if (bestNode == std::numeric_limits<uint32_t>::max() || sums[node] < sums[bestNode] ||
+            (sums[node] == sums[bestNode] && names[node] < names[bestNode])) {
+            bestNode = node;
+        }
+    }
+    return bestNode;
+}
+
+// Identifica as componentes que não recebem arestas de outras (fontes da condensação); só a única fonte,
+// se existir, contém vértices que alcançam todos os outros
+uint32_t CapitalFinder::findSourceComponent(const CSRGraph& graph, const std::vector<std::vector<uint32_t>>& components,
+                                            const std::vector<uint32_t>& componentOf) {
+    const uint32_t noVertex = std::numeric_limits<uint32_t>::max();
+    std::vector<char> hasIncoming(components.size(), false);
+    for (uint32_t node = 0; node < graph.numVertices(); ++node) {
+        for (uint32_t neighbor : graph.neighbors(node)) {
+            if (componentOf[neighbor] != componentOf[node]) {
+                hasIncoming[componentOf[neighbor]] = true;
+            }
+        }
+    }
+
+    uint32_t sourceComponent = noVertex;
+    for (uint32_t c = 0; c < components.size(); ++c) {
+        if (!hasIncoming[c]) {
+            if (sourceComponent != noVertex) {
+                return noVertex;
+            }
+            sourceComponent = c;
+        }
+    }
+    return sourceComponent;
+}
+
+// Encontra a capital com filtragem pela condensação, calculando as componentes fortemente conectadas
+uint32_t CapitalFinder::findCapitalPruned(const CSRGraph& graph, const std::vector<std::string>& names,
+                                          CapitalSearchStats* stats) {
+    auto components = Kosaraju::findConnectedComponents(graph);
+    std::vector<uint32_t> componentOf(graph.numVertices());
+    for (uint32_t c = 0; c < components.size(); ++c) {
+        for (uint32_t node : components[c]) {
+            componentOf[node] = c;
+        }
+    }
+    return findCapitalPruned(graph, names, components, componentOf, stats);
+}
+
+// Encontra a capital com filtragem pela condensação e BFS interrompidas por limite inferior
+uint32_t CapitalFinder::findCapitalPruned(const CSRGraph& graph, const std::vector<std::string>& names,
+                                          const std::vector<std::vector<uint32_t>>& components,
+                                          const std::vector<uint32_t>& componentOf,
+                                          CapitalSearchStats* stats, std::vector<uint64_t>* lowerBounds,
+                                          uint32_t seedNode, uint64_t seedSum) {
+    const uint32_t numVertices = graph.numVertices();
+    const uint32_t noVertex = std::numeric_limits<uint32_t>::max();
+    CapitalSearchStats localStats;
+    CapitalSearchStats& counters = stats ? *stats : localStats;
+    counters = CapitalSearchStats();
+    std::vector<uint64_t> localBounds;
+    std::vector<uint64_t>& bounds = lowerBounds ? *lowerBounds : localBounds;
+    bounds.assign(lowerBounds ? numVertices : 0, UNREACHABLE);
+
+    if (numVertices == 0) {
+        return noVertex;
+    }
+
+    // Passo 1: Só existe capital se houver exatamente uma componente fonte: apenas seus vértices alcançam todos
+    const uint32_t sourceComponent = findSourceComponent(graph, components, componentOf);
+    if (sourceComponent == noVertex) {
+        counters.filteredBySCC = numVertices;
+        return noVertex;
+    }
+
+    std::vector<uint32_t> candidates = components[sourceComponent];
+    counters.candidates = candidates.size();
+    counters.filteredBySCC = numVertices - candidates.size();
+
+    // Passo 2: Ordena os candidatos pelo limite inferior do grau de saída (mais vizinhos diretos primeiro)
+    std::sort(candidates.begin(), candidates.end(), [&](uint32_t a, uint32_t b) {
+        if (graph.outDegree(a) != graph.outDegree(b)) {
+            return graph.outDegree(a) > graph.outDegree(b);
+        }
+        return names[a] < names[b];
+    });
+
+    uint32_t bestNode = noVertex;
+    uint64_t bestSum = UNREACHABLE;
+    if (seedNode != noVertex) {
+        bestNode = seedNode;
+        bestSum = seedSum;
+        if (lowerBounds) {
+            bounds[seedNode] = seedSum;
+        }
+    }
+
+    // Um limite inferior só permite descartar a origem se não puder empatar com a melhor e vencer no nome
+    auto cannotWin = [&](uint32_t source, uint64_t lowerBound) {
+        return bestNode != noVertex &&
+               (lowerBound > bestSum || (lowerBound == bestSum && names[source] > names[bestNode]));
+    };
+    auto recordPrune = [&](uint64_t depth) {
+        counters.prunedRuns++;
+        if (counters.prunedAtDepth.size() <= depth) {
+            counters.prunedAtDepth.resize(depth + 1, 0);
+        }
+        counters.prunedAtDepth[depth]++;
+    };
+
+    BreadthFirstSearch bfs;
+    uint64_t edgesScanned = 0;
+
+    // Com pesos, o limite do nível 0 soma a estrada de entrada mais curta de cada um dos outros vértices
+    const bool weighted = graph.weighted();
+    std::vector<uint64_t> minIncoming;
+    uint64_t totalMinIncoming = 0;
+    if (weighted) {
+        minIncoming.assign(numVertices, UNREACHABLE);
+        for (uint32_t node = 0; node < numVertices; ++node) {
+            const uint32_t* weight = graph.neighborWeights(node);
+            for (uint32_t neighbor : graph.neighbors(node)) {
+                minIncoming[neighbor] = std::min<uint64_t>(minIncoming[neighbor], *weight++);
+            }
+        }
+        for (uint64_t& weight : minIncoming) {
+            weight = weight == UNREACHABLE ? 0 : weight;
+            totalMinIncoming += weight;
+        }
+    }
+
+    // Dijkstra podado: ao retirar da fila uma distância maior que as anteriores, todos os vértices mais
+    // próximos já estão fixados e os restantes estão a pelo menos essa distância
+    // As distâncias são alocadas uma única vez; cada busca devolve a UNREACHABLE só os vértices que a anterior
+    // tocou, para que um candidato podado cedo não custe O(V)
+    RadixHeap heap;
+    std::vector<uint64_t> weightedDistances;
+    std::vector<uint32_t> touched;
+    auto searchByDijkstra = [&](uint32_t source) {
+        const uint64_t levelZero = totalMinIncoming - minIncoming[source];
+        if (cannotWin(source, levelZero)) {
+            if (lowerBounds) {
+                bounds[source] = levelZero;
+            }
+            recordPrune(0);
+            return;
+        }
+
+        counters.bfsRuns++;
+        if (weightedDistances.empty()) {
+            weightedDistances.assign(numVertices, UNREACHABLE);
+        }
+        for (uint32_t node : touched) {
+            weightedDistances[node] = UNREACHABLE;
+        }
+        touched.clear();
+        heap.clear();
+        weightedDistances[source] = 0;
+        touched.push_back(source);
+        heap.push(0, source);
+
+        uint64_t partialSum = 0;
+        uint64_t settled = 0;
+        uint64_t depth = 0;
+        uint64_t lastDistance = 0;
+        bool pruned = false;
+        while (!heap.empty()) {
+            auto [distance, node] = heap.pop();
+            if (distance != weightedDistances[node]) {
+                continue;
+            }
+            if (distance > lastDistance) {
+                ++depth;
+                lastDistance = distance;
+                uint64_t remainder;
+                const uint64_t lowerBound = __builtin_mul_overflow(numVertices - settled, distance, &remainder) ||
+                                                    __builtin_add_overflow(partialSum, remainder, &remainder)
+                                                ? UNREACHABLE - 1
+                                                : remainder;
+                if (cannotWin(source, lowerBound)) {
+                    if (lowerBounds) {
+                        bounds[source] = lowerBound;
+                    }
+                    recordPrune(depth);
+                    pruned = true;
+                    break;
+                }
+            }
+            ++settled;
+            partialSum += distance;
+            edgesScanned += graph.outDegree(node);
+            const uint32_t* weight = graph.neighborWeights(node);
+            for (uint32_t neighbor : graph.neighbors(node)) {
+                const uint64_t candidate = distance + *weight++;
+                if (candidate < weightedDistances[neighbor]) {
+                    if (weightedDistances[neighbor] == UNREACHABLE) {
+                        touched.push_back(neighbor);
+                    }
+                    weightedDistances[neighbor] = candidate;
+                    heap.push(candidate, neighbor);
+                }
+            }
+        }
+        counters.verticesVisited += settled;
+        if (lowerBounds && !pruned && settled == numVertices) {
+            bounds[source] = partialSum;
+        }
+
+        if (!pruned && settled == numVertices &&
+            (bestNode == noVertex || partialSum < bestSum ||
+             (partialSum == bestSum && names[source] < names[bestNode]))) {
+            bestSum = partialSum;
+            bestNode = source;
+        }
+    };
+
+    for (uint32_t source : candidates) {
+        if (source == seedNode) {
+            continue;
+        }
+        if (weighted) {
+            searchByDijkstra(source);
+            continue;
+        }
+
+        // Limite do nível 0: no máximo outDegree vértices a distância 1, os demais a pelo menos 2
+        uint64_t remaining = numVertices - 1;
+        uint64_t nearest = std::min<uint64_t>(graph.outDegree(source), remaining);
+        if (cannotWin(source, nearest + 2 * (remaining - nearest))) {
+            if (lowerBounds) {
+                bounds[source] = nearest + 2 * (remaining - nearest);
+            }
+            recordPrune(0);
+            continue;
+        }
+
+        counters.bfsRuns++;
+
+        // BFS por níveis: quando o nível d fica conhecido, os níveis anteriores somam partialSum, os vértices
+        // do nível estão a exatamente d e os ainda não visitados, a pelo menos d + 1
+        uint64_t partialSum = 0;
+        uint64_t levelSize = 0;
+        bool pruned = false;
+        auto visitLevel = [&](uint32_t depth, const uint32_t* begin, const uint32_t* end) {
+            levelSize = static_cast<uint64_t>(end - begin);
+            const uint64_t unvisited = numVertices - bfs.visited().size();
+            const uint64_t lowerBound = partialSum + levelSize * depth + unvisited * (depth + 1);
+            if (depth > 0 && cannotWin(source, lowerBound)) {
+                if (lowerBounds) {
+                    bounds[source] = lowerBound;
+                }
+                recordPrune(depth);
+                pruned = true;
+                return false;
+            }
+            partialSum += levelSize * depth;
+            return true;
+        };
+        const size_t reached = bfs.run(graph, source, BreadthFirstSearch::Direction::Forward, visitLevel);
+
+        // Os vértices do nível que interrompeu a busca não chegaram a ser expandidos
+        counters.verticesVisited += pruned ? reached - levelSize : reached;
+        if (lowerBounds && !pruned && reached == numVertices) {
+            bounds[source] = partialSum;
+        }
+
+        if (!pruned && reached == numVertices &&
+            (bestNode == noVertex || partialSum < bestSum ||
+             (partialSum == bestSum && names[source] < names[bestNode]))) {
+            bestSum = partialSum;
+            bestNode = source;
+        }
+    }
+    if (weighted) {
+        INSTRUMENT_COUNT(ShortestPathRuns, counters.bfsRuns);
+        INSTRUMENT_COUNT(ShortestPathVerticesSettled, counters.verticesVisited);
+        INSTRUMENT_COUNT(ShortestPathEdgesScanned, edgesScanned);
+    } else {
+        INSTRUMENT_COUNT(BfsRuns, counters.bfsRuns);
+        INSTRUMENT_COUNT(BfsVerticesVisited, counters.verticesVisited);
+        INSTRUMENT_COUNT(BfsEdgesScanned, bfs.edgesScanned());
+    }
+    return bestNode;
+}
+
+// Estima as somas dos candidatos por pivôs sorteados e verifica as menores estimativas com BFS completas
+uint32_t CapitalFinder::findCapitalApproximate(const CSRGraph& graph, const std::vector<std::string>& names,
+                                               const std::vector<std::vector<uint32_t>>& components,
+                                               const std::vector<uint32_t>& componentOf,
+                                               const CapitalOptions& options, CapitalSearchStats* stats) {
+    if (graph.weighted()) {
+        return findCapitalPruned(graph, names, components, componentOf, stats);
+    }
+
+    const uint32_t numVertices = graph.numVertices();
+    const uint32_t noVertex = std::numeric_limits<uint32_t>::max();
+    CapitalSearchStats localStats;
+    CapitalSearchStats& counters = stats ? *stats : localStats;
+    counters = CapitalSearchStats();
+    if (numVertices == 0) {
+        return noVertex;
+    }
+
+    // Passo 1: Candidatos da componente fonte única
+    const uint32_t sourceComponent = findSourceComponent(graph, components, componentOf);
+    if (sourceComponent == noVertex) {
+        counters.filteredBySCC = numVertices;
+        return noVertex;
+    }
+    const std::vector<uint32_t>& candidates = components[sourceComponent];
+    counters.candidates = candidates.size();
+    counters.filteredBySCC = numVertices - candidates.size();
+
+    const unsigned workers = resolveThreadCount(options.numThreads);
+    std::vector<BreadthFirstSearch> searches(workers);
+    std::vector<uint64_t> verticesVisited(workers, 0);
+
+    // Passo 2: Pivôs distintos sorteados com semente fixa (todos os vértices se forem poucos, e então as
+    // estimativas são exatas)
+    const uint32_t numSamples = std::min(std::max<uint32_t>(options.samples, 1), numVertices);
+    std::vector<uint32_t> pivots;
+    if (numSamples == numVertices) {
+        pivots.resize(numVertices);
+        for (uint32_t v = 0; v < numVertices; ++v) {
+            pivots[v] = v;
+        }
+    } else {
+        std::mt19937_64 random(APPROXIMATION_SEED);
+        std::uniform_int_distribution<uint32_t> pick(0, numVertices - 1);
+        while (pivots.size() < numSamples) {
+            while (pivots.size() < numSamples) {
+                pivots.push_back(pick(random));
+            }
+            std::sort(pivots.begin(), pivots.end());
+            pivots.erase(std::unique(pivots.begin(), pivots.end()), pivots.end());
+        }
+    }
+    counters.samples = numSamples;
+
+    // Passo 3: Uma BFS reversa por pivô soma d(v, p) em cada candidato v
+    std::vector<std::atomic<uint64_t>> pivotSums(numVertices);
+    parallelFor(workers, pivots.size(), 1, [&](unsigned thread, size_t begin, size_t end) {
+        BreadthFirstSearch& bfs = searches[thread];
+        for (size_t i = begin; i < end; ++i) {
+            verticesVisited[thread] += bfs.run(graph, pivots[i], BreadthFirstSearch::Direction::Reverse);
+            for (uint32_t node : bfs.visited()) {
+                if (componentOf[node] == sourceComponent) {
+                    pivotSums[node].fetch_add(bfs.distance(node), std::memory_order_relaxed);
+                }
+            }
+        }
+    });
+
+    // Passo 4: Erro máximo. Para um candidato qualquer r, d(v, u) <= d(v, r) + d(r, u), então nenhuma
+    // distância de candidato passa de range = max d(v, r) + excentricidade de r. Pela desigualdade de Hoeffding
+    // (válida também na amostragem sem reposição) e pela união sobre os candidatos, cada estimativa fica a
+    // menos de n * range * sqrt(ln(2C / falha) / 2k) da soma exata
+    BreadthFirstSearch& bfs = searches[0];
+    const uint32_t reference = candidates.front();
+    uint64_t range = 0;
+    if (numSamples < numVertices) {
+        verticesVisited[0] += bfs.run(graph, reference);
+        const uint64_t eccentricity = bfs.distance(bfs.visited().back());
+        verticesVisited[0] += bfs.run(graph, reference, BreadthFirstSearch::Direction::Reverse);
+        uint64_t farthest = 0;
+        for (uint32_t candidate : candidates) {
+            farthest = std::max<uint64_t>(farthest, bfs.distance(candidate));
+        }
+        range = farthest + eccentricity;
+        counters.bfsRuns += 2;
+        counters.errorBound = static_cast<double>(numVertices) * static_cast<double>(range) *
+                              std::sqrt(std::log(2.0 * candidates.size() / APPROXIMATION_FAILURE) /
+                                        (2.0 * numSamples));
+    }
+    counters.bfsRuns += numSamples;
+
+    // Passo 5: Candidatos em ordem crescente de estimativa (desempate pelo nome)
+    const double scale = static_cast<double>(numVertices) / numSamples;
+    std::vector<double> estimate(numVertices, 0);
+    for (uint32_t candidate : candidates) {
+        estimate[candidate] = pivotSums[candidate].load(std::memory_order_relaxed) * scale;
+    }
+    std::vector<uint32_t> order = candidates;
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return estimate[a] != estimate[b] ? estimate[a] < estimate[b] : names[a] < names[b];
+    });
+
+    // Passo 6: Verificação em blocos de uma BFS por thread, aceitos em ordem até o limite ou até o próximo
+    // candidato ter estimativa menos o erro acima da melhor soma exata (e então todos os seguintes também).
+    // Só o prefixo aceito conta, então o resultado não depende do número de threads
+    const size_t verifyLimit = std::min<size_t>(std::max<uint32_t>(options.verified, 1), order.size());
+    std::vector<uint64_t> exactSums(workers);
+    uint32_t bestNode = noVertex;
+    uint64_t bestSum = UNREACHABLE;
+    size_t next = 0;
+    auto excluded = [&](size_t position) {
+        return bestNode != noVertex && estimate[order[position]] - counters.errorBound > static_cast<double>(bestSum);
+    };
+    while (next < verifyLimit && !excluded(next)) {
+        const size_t blockSize = std::min<size_t>(workers, verifyLimit - next);
+        parallelFor(workers, blockSize, 1, [&](unsigned thread, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                exactSums[i] = breadthFirstSum(searches[thread], graph, order[next + i]);
+            }
+        });
+        for (size_t i = 0; i < blockSize && !excluded(next); ++i, ++next) {
+            const uint32_t source = order[next];
+            counters.bfsRuns++;
+            counters.verified++;
+            counters.verticesVisited += numVertices;
+            if (bestNode == noVertex || exactSums[i] < bestSum ||
+                (exactSums[i] == bestSum && names[source] < names[bestNode])) {
+                bestSum = exactSums[i];
+                bestNode = source;
+            }
+        }
+    }
+    counters.certified = next == order.size() || excluded(next);
+
+    for (unsigned thread = 0; thread < workers; ++thread) {
+        counters.verticesVisited += verticesVisited[thread];
+        INSTRUMENT_COUNT(BfsEdgesScanned, searches[thread].edgesScanned());
+    }
+    INSTRUMENT_COUNT(BfsRuns, counters.bfsRuns);
+    INSTRUMENT_COUNT(BfsVerticesVisited, counters.verticesVisited);
+    return bestNode;
+}
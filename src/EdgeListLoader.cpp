@@ -0,0 +1,156 @@
+#include "../include/EdgeListLoader.hpp"
+#include "../include/Instrumentation.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+InputBuffer::InputBuffer(int fd) {
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        void* address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address != MAP_FAILED) {
+            madvise(address, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+            data = static_cast<const char*>(address);
+            length = static_cast<size_t>(info.st_size);
+            mapped = true;
+            return;
+        }
+    }
+
+    // Não mapeável: lê tudo para um buffer que dobra de tamanho conforme necessário, até o fim do arquivo
+    storage.resize(1 << 16);
+    for (;;) {
+        const ssize_t count = read(fd, storage.data() + length, storage.size() - length);
+        if (count == 0) {
+            break;
+        }
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            failed = true;
+            break;
+        }
+        length += static_cast<size_t>(count);
+        if (length == storage.size()) {
+            storage.resize(2 * storage.size());
+        }
+    }
+    data = storage.data();
+}
+
+InputBuffer::~InputBuffer() {
+    if (mapped) {
+        munmap(const_cast<char*>(data), length);
+    }
+}
+
+// Espaço em branco no sentido de operator>>: espaço e os caracteres de controle \t \n \v \f \r
+static inline bool isBlank(unsigned char c) {
+    return c <= ' ';
+}
+
+// Primeiro byte em branco a partir de p (ou end). Cada palavra de 8 bytes é testada de uma vez: um byte b
+// tem o bit alto marcado em (b - 0x21) & ~b exatamente quando b < 0x21; os empréstimos da subtração só
+// marcam bytes acima de um byte já marcado, então o menos significativo é sempre um acerto verdadeiro
+static inline const char* findBlank(const char* p, const char* end) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    constexpr uint64_t ones = 0x0101010101010101ULL;
+    constexpr uint64_t highBits = 0x8080808080808080ULL;
+    while (end - p >= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        uint64_t blanks = (word - ones * 0x21) & ~word & highBits;
+        if (blanks) {
+            return p + (__builtin_ctzll(blanks) >> 3);
+        }
+        p += 8;
+    }
+#endif
+    while (p < end && !isBlank(static_cast<unsigned char>(*p))) {
+        ++p;
+    }
+    return p;
+}
+
+bool TokenScanner::next(std::string_view& token) {
+    // Entre tokens costuma haver um único separador, então o salto é feito byte a byte
+    while (position < limit && isBlank(static_cast<unsigned char>(*position))) {
+        ++position;
+    }
+    if (position == limit) {
+        return false;
+    }
+    const char* start = position;
+    position = findBlank(position, limit);
+    token = std::string_view(start, static_cast<size_t>(position - start));
+    return true;
+}
+
+bool TokenScanner::nextOnLine(std::string_view& token) {
+    while (position < limit && *position != '\n' && isBlank(static_cast<unsigned char>(*position))) {
+        ++position;
+    }
+    if (position == limit || *position == '\n') {
+        return false;
+    }
+    return next(token);
+}
+
+// Converte o token em inteiro não negativo; falha se houver caracteres além dos dígitos
+static bool parseCount(std::string_view token, size_t& value) {
+    auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), value);
+    return error == std::errc() && end == token.data() + token.size();
+}
+
+bool EdgeListLoader::parseWeight(std::string_view token, uint32_t& weight) {
+    auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), weight);
+    return error == std::errc() && end == token.data() + token.size();
+}
+
+bool EdgeListLoader::load(int fd, Graph& graph) {
+    INSTRUMENT_STAGE("parse");
+    InputBuffer input(fd);
+    if (!input.good()) {
+        return false; // Uma entrada truncada não pode ser lida como se estivesse completa
+    }
+    TokenScanner scanner(input.begin(), input.end());
+
+    std::string_view token;
+    size_t numCenters, numEdges;
+    if (!scanner.next(token) || !parseCount(token, numCenters) ||
+        !scanner.next(token) || !parseCount(token, numEdges)) {
+        return false;
+    }
+
+    // O cabeçalho só orienta a reserva; cada estrada ocupa ao menos 4 bytes, o que limita cabeçalhos exagerados
+    const size_t reservedEdges = std::min(numEdges, static_cast<size_t>(input.end() - input.begin()) / 4);
+    graph.reserve(std::min(numCenters, 2 * reservedEdges), reservedEdges);
+
+    // A marca só é consumida se estiver na linha do cabeçalho; qualquer outro token ali já é a primeira estrada
+    bool weighted = false;
+    TokenScanner lookahead = scanner;
+    if (lookahead.nextOnLine(token) && token == WEIGHTED_MARKER) {
+        weighted = true;
+        scanner = lookahead;
+    }
+
+    for (size_t i = 0; i < numEdges; ++i) {
+        std::string_view from, to, weightToken;
+        if (!scanner.next(from) || !scanner.next(to)) {
+            return false;
+        }
+        uint32_t weight = 1;
+        if (weighted && (!scanner.next(weightToken) || !parseWeight(weightToken, weight))) {
+            return false;
+        }
+        uint32_t fromId = graph.intern(from);
+        graph.addEdge(fromId, graph.intern(to), weight);
+    }
+    return true;
+}
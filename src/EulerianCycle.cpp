@@ -1,34 +1,48 @@
 #include "../include/EulerianCycle.hpp"
 #include "../include/HungarianAlgorithm.hpp"
-#include <queue>
-#include <stack>
-#include <unordered_map>
+#include "../include/MinCostFlow.hpp"
+#include "../include/Parallel.hpp"
+#include "../include/Instrumentation.hpp"
+#include <algorithm>
 #include <limits>
+#include <utility>
+
+// Unidades de destino consideradas por unidade de origem no emparelhamento esparso
+static constexpr size_t SPARSE_CANDIDATES = 32;
 
 // Encontra um ciclo Euleriano a partir de um nó inicial
-std::vector<std::string> EulerianCycle::findCycleFromStart(
-    const std::unordered_map<std::string, std::vector<std::string>>& subgraph,
-    const std::string& startNode) {
+std::vector<uint32_t> EulerianCycle::findCycleFromStart(const Subgraph& subgraph, uint32_t startNode,
+                                                        std::pmr::memory_resource* memory) {
+    // Cada vértice consome suas arestas de trás para frente por um cursor, sem copiar o subgrafo
+    std::pmr::vector<uint32_t> cursor(subgraph.size(), memory);
+    size_t numEdges = 0;
+    for (uint32_t node = 0; node < subgraph.size(); ++node) {
+        cursor[node] = static_cast<uint32_t>(subgraph[node].size());
+        numEdges += subgraph[node].size();
+    }
 
-    std::unordered_map<std::string, std::vector<std::string>> tempGraph = subgraph;
-    std::stack<std::string> currentPath;
-    std::vector<std::string> eulerianCycle;
+    // O caminho atual e o ciclo têm no máximo numEdges + 1 vértices (mais o fechamento)
+    std::pmr::vector<uint32_t> currentPath(memory);
+    std::vector<uint32_t> eulerianCycle;
+    currentPath.reserve(numEdges + 1);
+    eulerianCycle.reserve(numEdges + 2);
 
-    currentPath.push(startNode);
+    currentPath.push_back(startNode);
 
     // Algoritmo de Hierholzer para encontrar o ciclo
     while (!currentPath.empty()) {
-        std::string current = currentPath.top();
+        uint32_t current = currentPath.back();
 
-        if (!tempGraph[current].empty()) {
-            currentPath.push(tempGraph[current].back());
-            tempGraph[current].pop_back();
+        if (cursor[current] != 0) {
+            currentPath.push_back(subgraph[current][--cursor[current]]);
         } else {
             eulerianCycle.push_back(current);
-            currentPath.pop();
+            currentPath.pop_back();
         }
     }
 
+    INSTRUMENT_COUNT(HierholzerEdges, numEdges);
+
     // Garante que o ciclo feche no nó inicial
     if (eulerianCycle.front() != eulerianCycle.back()) {
         eulerianCycle.push_back(eulerianCycle.front());
@@ -36,60 +50,232 @@ std::vector<std::string> EulerianCycle::findCycleFromStart(
     return eulerianCycle;
 }
 
-// Transforma o grafo em Euleriano adicionando arestas necessárias
-void EulerianCycle::transformToEulerian(
-    std::unordered_map<std::string, std::vector<std::string>>& subgraph,
-    const std::unordered_map<std::string, int>& balance) {
+// BFS a partir de uma origem, reaproveitando os buffers do chamador
+void EulerianCycle::bfs(const Subgraph& subgraph, uint32_t source, std::vector<uint32_t>& distance,
+                        std::vector<uint32_t>& parent, std::vector<uint32_t>& queue) {
+    distance.assign(subgraph.size(), std::numeric_limits<uint32_t>::max());
+    parent.assign(subgraph.size(), std::numeric_limits<uint32_t>::max());
+    queue.clear();
+    distance[source] = 0;
+    queue.push_back(source);
 
-    std::vector<std::string> positiveBalance, negativeBalance;
-
-    // Separa nós com balanço positivo e negativo
-    for (const auto& pair : balance) {
-        if (pair.second > 0) {
-            positiveBalance.insert(positiveBalance.end(), pair.second, pair.first);
-        } else if (pair.second < 0) {
-            negativeBalance.insert(negativeBalance.end(), -pair.second, pair.first);
+    for (size_t head = 0; head < queue.size(); ++head) {
+        uint32_t current = queue[head];
+        for (uint32_t neighbor : subgraph[current]) {
+            if (distance[neighbor] == std::numeric_limits<uint32_t>::max()) {
+                distance[neighbor] = distance[current] + 1;
+                parent[neighbor] = current;
+                queue.push_back(neighbor);
+            }
         }
     }
+}
 
-    // Cria a matriz de custo baseada em distâncias
-    std::vector<std::vector<int>> costMatrix(negativeBalance.size(),
-                                             std::vector<int>(positiveBalance.size(),
-                                                              std::numeric_limits<int>::max()));
+// Transforma o grafo em Euleriano com o algoritmo de balanceamento escolhido
+uint64_t EulerianCycle::transformToEulerian(Subgraph& subgraph, const std::vector<int>& balance,
+                                            BalancingMode mode, unsigned numThreads,
+                                            std::pmr::memory_resource* memory) {
+    uint64_t duplicated;
+    if (mode == BalancingMode::Hungarian || mode == BalancingMode::SparseHungarian) {
+        duplicated = balanceByMatching(subgraph, balance, numThreads, mode == BalancingMode::SparseHungarian);
+    } else {
+        duplicated = balanceByMinCostFlow(subgraph, balance, memory);
+    }
+    INSTRUMENT_COUNT(EdgesDuplicated, duplicated);
+    return duplicated;
+}
+
+// Duplica caminhos mínimos entre os pares de vértices desbalanceados escolhidos pelo Algoritmo Húngaro
+uint64_t EulerianCycle::balanceByMatching(Subgraph& subgraph, const std::vector<int>& balance, unsigned numThreads,
+                                          bool sparse) {
+    std::vector<uint32_t> positiveBalance, negativeBalance;
+    std::vector<uint32_t> sources, targets;                 // Vértices distintos com excesso de entrada e de saída
+    std::vector<uint32_t> sourceIndex(balance.size(), 0), targetIndex(balance.size(), 0);
+    std::vector<uint32_t> firstUnit;                        // Primeira unidade de cada destino em positiveBalance
 
-    for (size_t i = 0; i < negativeBalance.size(); ++i) {
-        for (size_t j = 0; j < positiveBalance.size(); ++j) {
-            costMatrix[i][j] = subgraph.at(negativeBalance[i]).size();
+    // Separa nós com balanço positivo (precisam de entradas) e negativo (precisam de saídas)
+    for (uint32_t node = 0; node < balance.size(); ++node) {
+        if (balance[node] > 0) {
+            targetIndex[node] = static_cast<uint32_t>(targets.size());
+            targets.push_back(node);
+            firstUnit.push_back(static_cast<uint32_t>(positiveBalance.size()));
+            positiveBalance.insert(positiveBalance.end(), balance[node], node);
+        } else if (balance[node] < 0) {
+            sourceIndex[node] = static_cast<uint32_t>(sources.size());
+            sources.push_back(node);
+            negativeBalance.insert(negativeBalance.end(), -balance[node], node);
         }
     }
+    if (sources.empty()) {
+        return 0;
+    }
 
-    // Resolve o emparelhamento mínimo usando o Algoritmo Húngaro
+    const unsigned workers = resolveThreadCount(numThreads);
+    struct Scratch {
+        std::vector<uint32_t> distance, parent, queue;
+    };
+    std::vector<Scratch> scratchBuffers(workers);
+
+    // Passo 1: Uma BFS por vértice de origem distinto, guardando apenas as distâncias até os destinos
+    std::vector<std::vector<uint32_t>> distances(sources.size(), std::vector<uint32_t>(targets.size()));
+    parallelFor(workers, sources.size(), 1, [&](unsigned thread, size_t begin, size_t end) {
+        Scratch& scratch = scratchBuffers[thread];
+        for (size_t s = begin; s < end; ++s) {
+            bfs(subgraph, sources[s], scratch.distance, scratch.parent, scratch.queue);
+            for (size_t t = 0; t < targets.size(); ++t) {
+                distances[s][t] = scratch.distance[targets[t]];
+            }
+        }
+    });
+
+    // Passo 2: Emparelha as unidades de excesso de saída e de entrada pelas distâncias reais
     HungarianAlgorithm hungarian;
-    auto matching = hungarian.solve(costMatrix);
+    std::vector<int> matching;
+
+    if (sparse) {
+        // Cada unidade de uma origem só considera as unidades dos destinos mais próximos, sem montar a matriz densa
+        SparseCostMatrix candidates;
+        candidates.numCols = positiveBalance.size();
+        std::vector<uint32_t> order(targets.size());
+        std::vector<std::pair<uint32_t, int>> entries;
+
+        for (size_t s = 0; s < sources.size(); ++s) {
+            const std::vector<uint32_t>& row = distances[s];
+            for (uint32_t t = 0; t < order.size(); ++t) {
+                order[t] = t;
+            }
+            std::sort(order.begin(), order.end(), [&row](uint32_t a, uint32_t b) {
+                return row[a] != row[b] ? row[a] < row[b] : a < b;
+            });
+
+            const size_t multiplicity = static_cast<size_t>(-balance[sources[s]]);
+            const size_t wanted = std::max(SPARSE_CANDIDATES, 2 * multiplicity);
+            entries.clear();
+            for (size_t k = 0; k < order.size() && entries.size() < wanted; ++k) {
+                uint32_t t = order[k];
+                for (int unit = 0; unit < balance[targets[t]]; ++unit) {
+                    entries.emplace_back(firstUnit[t] + unit, static_cast<int>(row[t]));
+                }
+            }
+            for (size_t unit = 0; unit < multiplicity; ++unit) {
+                for (const auto& entry : entries) {
+                    candidates.addEntry(entry.first, entry.second);
+                }
+                candidates.endRow();
+            }
+        }
+
+        matching = hungarian.solve(candidates);
+
+        // Se alguma unidade ficou sem par entre as candidatas, recorre à matriz densa
+        if (std::find(matching.begin(), matching.end(), -1) != matching.end()) {
+            matching.clear();
+        }
+    }
+
+    if (matching.empty()) {
+        CostMatrix costMatrix(negativeBalance.size(), positiveBalance.size());
+        for (size_t i = 0; i < negativeBalance.size(); ++i) {
+            const std::vector<uint32_t>& row = distances[sourceIndex[negativeBalance[i]]];
+            int* costs = costMatrix.row(i);
+            for (size_t j = 0; j < positiveBalance.size(); ++j) {
+                costs[j] = static_cast<int>(row[targetIndex[positiveBalance[j]]]);
+            }
+        }
+        matching = hungarian.solve(costMatrix);
+    }
 
-    // Adiciona as arestas necessárias para balancear
+    // Agrupa os destinos emparelhados por origem
+    std::vector<std::vector<uint32_t>> matchedTargets(sources.size());
     for (size_t i = 0; i < matching.size(); ++i) {
         if (matching[i] != -1) {
-            subgraph[negativeBalance[i]].push_back(positiveBalance[matching[i]]);
+            matchedTargets[sourceIndex[negativeBalance[i]]].push_back(positiveBalance[matching[i]]);
         }
     }
+
+    // Passo 3: Refaz a BFS de cada origem (evita guardar uma árvore de predecessores por origem) e
+    // reconstrói os caminhos mínimos até os destinos emparelhados
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> pathEdges(sources.size());
+    parallelFor(workers, sources.size(), 1, [&](unsigned thread, size_t begin, size_t end) {
+        Scratch& scratch = scratchBuffers[thread];
+        for (size_t s = begin; s < end; ++s) {
+            bfs(subgraph, sources[s], scratch.distance, scratch.parent, scratch.queue);
+            for (uint32_t target : matchedTargets[s]) {
+                for (uint32_t node = target; node != sources[s]; node = scratch.parent[node]) {
+                    pathEdges[s].emplace_back(scratch.parent[node], node);
+                }
+            }
+        }
+    });
+
+    // Passo 4: Duplica as estradas dos caminhos, em ordem determinística
+    uint64_t extraDistance = 0;
+    for (const auto& edges : pathEdges) {
+        for (const auto& edge : edges) {
+            subgraph[edge.first].push_back(edge.second);
+        }
+        extraDistance += edges.size();
+    }
+    return extraDistance;
 }
 
-// Calcula o balanço dos graus de entrada e saída de cada nó
-std::unordered_map<std::string, int> EulerianCycle::calculateBalance(
-    const std::unordered_map<std::string, std::vector<std::string>>& subgraph) {
+// Modela o balanceamento como fluxo: a origem fictícia alimenta cada vértice com excesso de entrada (balanço
+// negativo) com a sua falta de saídas, cada estrada tem capacidade ilimitada e custo 1, e cada vértice com
+// excesso de saída escoa para o destino fictício a sua falta de entradas
+uint64_t EulerianCycle::balanceByMinCostFlow(Subgraph& subgraph, const std::vector<int>& balance,
+                                             std::pmr::memory_resource* memory) {
+    const uint32_t numNodes = static_cast<uint32_t>(subgraph.size());
+    const uint32_t source = numNodes;
+    const uint32_t sink = numNodes + 1;
 
-    std::unordered_map<std::string, int> balance;
+    int64_t imbalance = 0;
+    for (int value : balance) {
+        if (value > 0) {
+            imbalance += value;
+        }
+    }
+    if (imbalance == 0) {
+        return 0;
+    }
 
-    // Inicializa o balanço para cada nó
-    for (const auto& pair : subgraph) {
-        balance[pair.first] = 0;
+    MinCostFlow network(numNodes + 2, memory);
+    std::pmr::vector<uint32_t> roadArcs(memory); // Arco de cada estrada, na ordem das listas de adjacência
+    for (uint32_t node = 0; node < numNodes; ++node) {
+        for (uint32_t neighbor : subgraph[node]) {
+            roadArcs.push_back(network.addArc(node, neighbor, imbalance, 1));
+        }
+    }
+    for (uint32_t node = 0; node < numNodes; ++node) {
+        if (balance[node] < 0) {
+            network.addArc(source, node, -balance[node], 0);
+        } else if (balance[node] > 0) {
+            network.addArc(node, sink, balance[node], 0);
+        }
+    }
+
+    auto result = network.solve(source, sink, imbalance);
+
+    // Duplica as estradas com fluxo, na ordem das listas de adjacência
+    size_t road = 0;
+    for (uint32_t node = 0; node < numNodes; ++node) {
+        const size_t degree = subgraph[node].size();
+        for (size_t k = 0; k < degree; ++k) {
+            int64_t flow = network.flow(roadArcs[road++]);
+            uint32_t neighbor = subgraph[node][k];
+            subgraph[node].insert(subgraph[node].end(), static_cast<size_t>(flow), neighbor);
+        }
     }
+    return static_cast<uint64_t>(result.second);
+}
+
+// Calcula o balanço dos graus de entrada e saída de cada nó
+std::vector<int> EulerianCycle::calculateBalance(const Subgraph& subgraph) {
+    std::vector<int> balance(subgraph.size(), 0);
 
     // Atualiza o balanço de acordo com as arestas
-    for (const auto& pair : subgraph) {
-        for (const auto& neighbor : pair.second) {
-            balance[pair.first]++;
+    for (uint32_t node = 0; node < subgraph.size(); ++node) {
+        for (uint32_t neighbor : subgraph[node]) {
+            balance[node]++;
             balance[neighbor]--;
         }
     }
@@ -1,231 +1,489 @@
 #include "../include/Graph.hpp"
-#include "../include/Kosaraju.hpp"
 #include "../include/EulerianCycle.hpp"
-#include <queue>
-#include <unordered_set>
+#include "../include/Parallel.hpp"
+#include "../include/Instrumentation.hpp"
+#include "../include/Memory.hpp"
+#include <algorithm>
+#include <atomic>
 #include <limits>
-
-// Função Auxiliar: Verifica se um vetor contém um elemento específico
-bool contains(const std::vector<std::string>& vec, const std::string& value) {
-    for (size_t i = 0; i < vec.size(); ++i) {
-        if (vec[i] == value) {
-            return true;
-        }
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+// Interna um nome, atribuindo-lhe o próximo identificador denso caso ainda não exista
+uint32_t Graph::intern(std::string_view location) {
+    const size_t numNames = idToName.size();
+    uint32_t id = nameTable.intern(location, idToName);
+    if (idToName.size() == numNames) {
+        return id;
     }
-    return false;
+    nameRankValid = false;
+    frozenValid = false;
+    analysisValid = false;
+    return id;
 }
 
-// Função Auxiliar: Ordena um vetor de strings em ordem lexicográfica
-void sortStrings(std::vector<std::string>& vec) {
-    for (size_t i = 0; i < vec.size(); ++i) {
-        for (size_t j = i + 1; j < vec.size(); ++j) {
-            if (vec[i] > vec[j]) {
-                // Troca manual dos elementos
-                std::string temp = vec[i];
-                vec[i] = vec[j];
-                vec[j] = temp;
-            }
-        }
-    }
+// Identificador de um nome já internado, sem alterar o grafo
+uint32_t Graph::idOf(std::string_view location) const {
+    uint32_t id = nameTable.find(location, idToName);
+    return id == NameTable::NOT_FOUND ? NO_VERTEX : id;
 }
 
-// Função Auxiliar: Inverte a ordem dos elementos de um vetor
-void reverseVector(std::vector<std::string>& vec) {
-    size_t start = 0;
-    size_t end = vec.size() - 1;
-    while (start < end) {
-        // Troca manual dos elementos
-        std::string temp = vec[start];
-        vec[start] = vec[end];
-        vec[end] = temp;
-        ++start;
-        --end;
-    }
+// Adiciona um nó ao grafo, caso ele não exista
+void Graph::addNode(const std::string& location) {
+    intern(location);
 }
 
-// Função Auxiliar: Ordena um vetor de rotas (vetores de strings) em ordem lexicográfica
-void sortRoutes(std::vector<std::vector<std::string>>& routes) {
-    for (size_t i = 0; i < routes.size(); ++i) {
-        for (size_t j = i + 1; j < routes.size(); ++j) {
-            if (routes[i] > routes[j]) {
-                std::swap(routes[i], routes[j]);
-            }
-        }
-    }
+// Adiciona uma aresta direcionada ao grafo
+void Graph::addEdge(const std::string& from, const std::string& to, uint32_t weight) {
+    uint32_t fromId = intern(from);
+    uint32_t toId = intern(to);
+    addEdge(fromId, toId, weight);
 }
 
-
-// Adiciona um nó ao grafo, caso ele não exista
-void Graph::addNode(const std::string& location) {
-    if (adjacencyList.find(location) == adjacencyList.end()) {
-        adjacencyList[location] = {};
+// Adiciona uma aresta direcionada entre dois centros já internados; os pesos só passam a ser guardados
+// a partir da primeira estrada com peso diferente de 1
+void Graph::addEdge(uint32_t fromId, uint32_t toId, uint32_t weight) {
+    if (weight != 1 || !edgeWeights.empty()) {
+        edgeWeights.resize(edges.size(), 1);
+        edgeWeights.push_back(weight);
     }
+    edges.emplace_back(fromId, toId);
+    frozenValid = false;
+    analysisValid = false;
 }
 
-// Adiciona uma aresta direcionada ao grafo
-void Graph::addEdge(const std::string& from, const std::string& to) {
-    adjacencyList[from].push_back(to);
+// Reserva espaço para os nomes e arestas anunciados no cabeçalho da entrada
+void Graph::reserve(size_t numNodes, size_t numEdges) {
+    nameTable.reserve(numNodes);
+    idToName.reserve(numNodes);
+    edges.reserve(edges.size() + numEdges);
 }
 
-// Encontra a capital como o nó que minimiza a soma das distâncias para todos os outros
-std::string Graph::findCapital() {
-    std::string bestNode;
-    int minTotalDistance = std::numeric_limits<int>::max();
+// Substitui o conteúdo do grafo por nomes e CSR já prontos
+void Graph::loadFrozen(std::vector<std::string> names, CSRGraph graph) {
+    idToName = std::move(names);
+    nameTable.rebuild(idToName);
+    edges.clear();
+    edgeWeights.clear();
+    frozenGraph = std::move(graph);
+    frozenValid = true;
+    edgesInFrozenGraph = true;
+    nameRankValid = false;
+    analysisValid = false;
+}
 
-    for (const auto& pair : adjacencyList) {
-        const std::string& start = pair.first;
-        std::unordered_map<std::string, int> distances;
+// Instala uma análise já calculada para o grafo atual
+void Graph::restoreAnalysis(GraphAnalysis analysis) {
+    cachedAnalysis = std::move(analysis);
+    routeCache.clear();
+    analysisValid = true;
+}
 
-        for (const auto& node : adjacencyList) {
-            distances[node.first] = std::numeric_limits<int>::max();
-        }
-        distances[start] = 0;
+// Altera a configuração da análise, descartando o resultado memorizado
+void Graph::setAnalysisOptions(const AnalysisOptions& options) {
+    analysisOptions = options;
+    analysisValid = false;
+}
 
-        std::queue<std::string> q;
-        q.push(start);
+// Recupera as arestas de um grafo carregado já congelado, antes das inseridas desde então, agrupadas por origem
+void Graph::materializeEdges() {
+    if (!edgesInFrozenGraph) {
+        return;
+    }
+    std::vector<std::pair<uint32_t, uint32_t>> loaded;
+    loaded.reserve(frozenGraph.numEdges() + edges.size());
+    for (uint32_t v = 0; v < frozenGraph.numVertices(); ++v) {
+        for (uint32_t neighbor : frozenGraph.neighbors(v)) {
+            loaded.emplace_back(v, neighbor);
+        }
+    }
+    loaded.insert(loaded.end(), edges.begin(), edges.end());
+    edges.swap(loaded);
+
+    // Os pesos da CSR já seguem a ordem agrupada por origem; as arestas acrescentadas depois pesam 1 se ainda
+    // não houver pesos guardados
+    if (frozenGraph.weighted() || !edgeWeights.empty()) {
+        std::vector<uint32_t> loadedWeights(frozenGraph.numEdges(), 1);
+        if (frozenGraph.weighted()) {
+            loadedWeights.assign(frozenGraph.arrays().weights, frozenGraph.arrays().weights + frozenGraph.numEdges());
+        }
+        if (edgeWeights.empty()) {
+            loadedWeights.resize(edges.size(), 1);
+        } else {
+            loadedWeights.insert(loadedWeights.end(), edgeWeights.begin(), edgeWeights.end());
+        }
+        edgeWeights.swap(loadedWeights);
+    }
+    edgesInFrozenGraph = false;
+}
 
-        while (!q.empty()) {
-            std::string current = q.front();
-            q.pop();
+// Aplica o lote: remove as últimas ocorrências das estradas pedidas em uma única passada (preservando a
+// ordem das demais), acrescenta as novas e, se havia análise, atualiza-a a partir da anterior
+size_t Graph::applyUpdates(const std::vector<RoadUpdate>& updates) {
+    INSTRUMENT_STAGE("updates");
+    const bool incremental = analysisValid;
+    materializeEdges();
+
+    // Quantas ocorrências de cada estrada (origem e destino em 64 bits) devem ser removidas
+    std::unordered_map<uint64_t, uint32_t> pendingRemovals;
+    for (const RoadUpdate& update : updates) {
+        if (update.kind != RoadUpdate::Remove) {
+            continue;
+        }
+        uint32_t fromId = nameTable.find(update.from, idToName);
+        uint32_t toId = nameTable.find(update.to, idToName);
+        if (fromId != NameTable::NOT_FOUND && toId != NameTable::NOT_FOUND) {
+            pendingRemovals[(uint64_t(fromId) << 32) | toId]++;
+        }
+    }
 
-            for (const auto& neighbor : adjacencyList[current]) {
-                if (distances[neighbor] == std::numeric_limits<int>::max()) {
-                    distances[neighbor] = distances[current] + 1;
-                    q.push(neighbor);
-                }
+    EdgeBatch batch;
+    if (!pendingRemovals.empty()) {
+        std::vector<char> removed(edges.size(), false);
+        for (size_t i = edges.size(); i-- > 0;) {
+            auto it = pendingRemovals.find((uint64_t(edges[i].first) << 32) | edges[i].second);
+            if (it != pendingRemovals.end() && it->second > 0) {
+                it->second--;
+                removed[i] = true;
+                batch.removed.push_back(edges[i]);
             }
         }
-
-        int totalDistance = 0;
-        for (const auto& dist : distances) {
-            if (dist.second == std::numeric_limits<int>::max()) {
-                totalDistance = std::numeric_limits<int>::max();
-                break;
+        size_t kept = 0;
+        for (size_t i = 0; i < edges.size(); ++i) {
+            if (!removed[i]) {
+                if (!edgeWeights.empty()) {
+                    edgeWeights[kept] = edgeWeights[i];
+                }
+                edges[kept++] = edges[i];
             }
-            totalDistance += dist.second;
         }
-
-        if (totalDistance < minTotalDistance || 
-            (totalDistance == minTotalDistance && start < bestNode)) {
-            minTotalDistance = totalDistance;
-            bestNode = start;
+        edges.resize(kept);
+        if (!edgeWeights.empty()) {
+            edgeWeights.resize(kept);
         }
     }
-    return bestNode;
-}
 
-// Determina os batalhões secundários necessários para garantir conectividade de retorno
-std::vector<std::string> Graph::findSecondaryBattalions() {
-    std::vector<std::string> secondaryBattalions;
-    std::string capital = findCapital();
-
-    auto components = Kosaraju::findConnectedComponents(adjacencyList);
-    std::unordered_map<std::string, int> distances;
+    for (const RoadUpdate& update : updates) {
+        if (update.kind == RoadUpdate::Insert) {
+            uint32_t fromId = intern(update.from);
+            batch.inserted.emplace_back(fromId, intern(update.to));
+            addEdge(fromId, batch.inserted.back().second, update.weight);
+        }
+    }
 
-    for (const auto& pair : adjacencyList) {
-        distances[pair.first] = std::numeric_limits<int>::max();
+    const size_t applied = batch.inserted.size() + batch.removed.size();
+    if (applied == 0) {
+        return 0;
+    }
+    frozenValid = false;
+    analysisValid = false;
+    if (!incremental) {
+        return applied;
     }
-    distances[capital] = 0;
 
-    std::queue<std::string> q;
-    q.push(capital);
+    // Atualiza a análise e leva as rotas memorizadas para a nova numeração das componentes
+    std::vector<uint32_t> previousComponent;
+    cachedAnalysis = IncrementalAnalysis::update(cachedAnalysis, csr(), idToName, analysisOptions, batch,
+                                                 previousComponent);
+    std::vector<CachedRoute> remapped(previousComponent.size());
+    for (uint32_t c = 0; c < previousComponent.size(); ++c) {
+        if (previousComponent[c] != NO_VERTEX && previousComponent[c] < routeCache.size()) {
+            remapped[c] = std::move(routeCache[previousComponent[c]]);
+        }
+    }
+    routeCache.swap(remapped);
+    analysisValid = true;
+    return applied;
+}
 
-    while (!q.empty()) {
-        std::string current = q.front();
-        q.pop();
+// Retorna a CSR do grafo, reconstruindo-a apenas se houve alterações desde o último congelamento
+const CSRGraph& Graph::csr() {
+    if (!frozenValid) {
+        INSTRUMENT_STAGE("csr");
+        materializeEdges();
+        // Pesos todos iguais a 1 (ex.: após remover as estradas com outros pesos) mantêm o caminho sem pesos
+        const bool weighted = std::any_of(edgeWeights.begin(), edgeWeights.end(), [](uint32_t w) { return w != 1; });
+        frozenGraph = CSRGraph(numVertices(), edges, weighted ? edgeWeights : std::vector<uint32_t>());
+        frozenValid = true;
+    }
+    return frozenGraph;
+}
 
-        for (const auto& neighbor : adjacencyList[current]) {
-            if (distances[neighbor] == std::numeric_limits<int>::max()) {
-                distances[neighbor] = distances[current] + 1;
-                q.push(neighbor);
-            }
-        }
+// Retorna a análise do grafo, calculando-a apenas na primeira consulta após uma alteração
+const GraphAnalysis& Graph::analysis() {
+    if (!analysisValid) {
+        cachedAnalysis = GraphAnalysis::compute(csr(), idToName, analysisOptions);
+        routeCache.clear();
+        analysisValid = true;
     }
+    return cachedAnalysis;
+}
 
-    for (const auto& component : components) {
-        if (contains(component, capital)) {
-            continue;
+// Retorna a posição de cada nome na ordem lexicográfica, ordenando os nomes apenas uma vez por alteração
+const std::vector<uint32_t>& Graph::nameRanks() {
+    if (!nameRankValid) {
+        std::vector<uint32_t> order(numVertices());
+        for (uint32_t id = 0; id < order.size(); ++id) {
+            order[id] = id;
         }
+        std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) { return idToName[a] < idToName[b]; });
 
-        if (!component.empty()) {
-            std::string closestNode;
-            int minDistance = std::numeric_limits<int>::max();
-            for (const auto& node : component) {
-                if (distances[node] < minDistance) {
-                    minDistance = distances[node];
-                    closestNode = node;
-                }
-            }
-            secondaryBattalions.push_back(closestNode);
+        nameRank.resize(order.size());
+        for (uint32_t position = 0; position < order.size(); ++position) {
+            nameRank[order[position]] = position;
         }
+        nameRankValid = true;
     }
+    return nameRank;
+}
 
-    sortStrings(secondaryBattalions);
-    return secondaryBattalions;
+// Converte uma sequência de identificadores em nomes
+std::vector<std::string> Graph::toNames(const std::vector<uint32_t>& ids) const {
+    std::vector<std::string> names;
+    names.reserve(ids.size());
+    for (uint32_t id : ids) {
+        names.push_back(id == NO_VERTEX ? std::string() : idToName[id]);
+    }
+    return names;
+}
+
+// Encontra a capital como o nó que minimiza a soma das distâncias para todos os outros
+std::string Graph::findCapital() {
+    uint32_t capital = analysis().capital;
+    return capital == NO_VERTEX ? std::string() : idToName[capital];
+}
+
+// Determina os batalhões secundários necessários para garantir conectividade de retorno
+std::vector<std::string> Graph::findSecondaryBattalions() {
+    std::vector<uint32_t> battalions = analysis().secondaryBattalions;
+    const std::vector<uint32_t>& rank = nameRanks();
+
+    // Ordena pelos postos dos nomes; componentes sem batalhão (nome vazio) vêm primeiro
+    auto key = [&rank](uint32_t id) { return id == NO_VERTEX ? 0 : uint64_t(rank[id]) + 1; };
+    std::sort(battalions.begin(), battalions.end(), [&key](uint32_t a, uint32_t b) { return key(a) < key(b); });
+    return toNames(battalions);
 }
 
 // Encontra rotas de patrulhamento Eulerianas que cobrem todas as arestas
 std::vector<std::vector<std::string>> Graph::findPatrolRoutes() {
     std::vector<std::vector<std::string>> routes;
-    auto components = Kosaraju::findConnectedComponents(adjacencyList);
-
-    std::string capital = findCapital();
-    std::vector<std::string> secondaryBattalions = findSecondaryBattalions();
-    std::unordered_set<std::string> allBattalions(secondaryBattalions.begin(), secondaryBattalions.end());
-    allBattalions.insert(capital);
+    for (const auto& route : findPatrolRouteIds()) {
+        routes.push_back(toNames(route));
+    }
+    return routes;
+}
 
-    for (const auto& component : components) {
-        if (component.size() <= 1) continue;
+// Gera as rotas de patrulhamento como identificadores, ordenadas pela sequência de nomes
+std::vector<std::vector<uint32_t>> Graph::findPatrolRouteIds() {
+    std::vector<std::vector<uint32_t>> routes;
+    routes.reserve(numPatrolRoutes());
+    streamPatrolRoutes([&routes](const std::vector<uint32_t>& route) { routes.push_back(route); });
+    return routes;
+}
 
-        auto subgraph = generateSubgraph(component);
-        auto balance = EulerianCycle::calculateBalance(subgraph);
+// Número de rotas: uma por componente com mais de um vértice (componentes fortemente conexas desse
+// tamanho sempre têm estradas internas)
+size_t Graph::numPatrolRoutes() {
+    size_t count = 0;
+    for (const auto& component : analysis().components) {
+        count += component.size() > 1;
+    }
+    return count;
+}
 
-        bool isEulerian = true;
-        for (const auto& pair : balance) {
-            if (pair.second != 0) {
-                isEulerian = false;
-                break;
-            }
+// Entrega as rotas na ordem da saída assim que cada prefixo dessa ordem fica pronto. As rotas cobrem
+// componentes disjuntas e começam no vértice inicial da sua componente, então a ordem (pelo posto do nome
+// desse vértice) é conhecida antes de calcular qualquer rota. As componentes são independentes e calculadas
+// em paralelo na ordem da saída, de modo que a escrita das primeiras rotas se sobrepõe ao cálculo das demais
+void Graph::streamPatrolRoutes(const std::function<void(const std::vector<uint32_t>&)>& visit) {
+    const GraphAnalysis& result = analysis();
+    const CSRGraph& graph = csr();
+    INSTRUMENT_STAGE("routes");
+    lastPatrolStats = PatrolStats();
+
+    // Vértice inicial de cada componente com rota: o seu batalhão (ou a capital), ou o membro de menor nome, que
+    // não depende da ordem de inserção dos centros
+    const std::vector<uint32_t>& rank = nameRanks();
+    routeCache.resize(result.components.size());
+    std::vector<uint32_t> startOf(result.components.size(), NO_VERTEX);
+    for (uint32_t c = 0; c < result.components.size(); ++c) {
+        const auto& component = result.components[c];
+        if (component.size() <= 1) {
+            continue;
         }
+        startOf[c] = result.componentBattalion[c];
+        if (startOf[c] == NO_VERTEX) {
+            startOf[c] = *std::min_element(component.begin(), component.end(),
+                                           [&rank](uint32_t a, uint32_t b) { return rank[a] < rank[b]; });
+        }
+    }
 
-        if (!isEulerian) {
-            EulerianCycle::transformToEulerian(subgraph, balance);
+    // Ordem da saída: posto do nome do vértice inicial, que é o primeiro da rota
+    std::vector<std::pair<uint32_t, uint32_t>> keys; // (posto do nome inicial, componente)
+    for (uint32_t c = 0; c < result.components.size(); ++c) {
+        if (startOf[c] != NO_VERTEX) {
+            keys.emplace_back(rank[startOf[c]], c);
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+
+    // Rotas memorizadas continuam válidas enquanto a componente e o seu início não mudarem; as demais são
+    // calculadas, e cada posição da ordem fica pronta quando a sua rota estiver no cache
+    std::unique_ptr<std::atomic<bool>[]> ready(new std::atomic<bool>[keys.size()]);
+    std::vector<size_t> tasks; // Posições na ordem da saída
+    for (size_t position = 0; position < keys.size(); ++position) {
+        const CachedRoute& cached = routeCache[keys[position].second];
+        const bool valid = cached.valid && cached.startNode == startOf[keys[position].second];
+        ready[position].store(valid, std::memory_order_relaxed);
+        if (!valid) {
+            tasks.push_back(position);
         }
+    }
 
-        std::string startNode;
-        for (const auto& node : component) {
-            if (allBattalions.count(node)) {
-                startNode = node;
-                break;
+    // Se as rotas de todas as componentes (ao menos uma entrada por estrada) não couberem no limite de memória
+    // junto com o que já está residente, cada rota é descartada assim que entregue e recalculada na próxima vez
+    const uint64_t budget = analysisOptions.memoryBudget;
+    const bool keepRoutes = MemoryBudget::fits(budget, (uint64_t(graph.numEdges()) + keys.size()) * sizeof(uint32_t));
+    if (!keepRoutes) {
+        INSTRUMENT_COUNT(CompactFallbacks, 1);
+    }
+    auto deliver = [&](size_t position) {
+        CachedRoute& cached = routeCache[keys[position].second];
+        visit(cached.route);
+        if (!keepRoutes) {
+            cached.valid = false;
+            std::vector<uint32_t>().swap(cached.route);
+        }
+    };
+
+    // Entrega o prefixo pronto; só uma thread entrega por vez, e quem não consegue o lock deixa o trabalho
+    // para a dona atual ou para a entrega final após o cálculo
+    std::mutex emitMutex;
+    std::atomic<size_t> nextToEmit{0};
+    auto emitReady = [&]() {
+        while (nextToEmit.load() < keys.size() && ready[nextToEmit.load()].load()) {
+            std::unique_lock<std::mutex> lock(emitMutex, std::try_to_lock);
+            if (!lock.owns_lock()) {
+                return;
             }
+            size_t position = nextToEmit.load();
+            for (; position < keys.size() && ready[position].load(); ++position) {
+                deliver(position);
+            }
+            nextToEmit.store(position);
         }
+    };
+    emitReady();
+
+    // Com várias componentes o paralelismo fica entre elas; com uma só, o balanceamento usa todas as threads
+    const unsigned workers = resolveThreadCount(analysisOptions.capital.numThreads);
+    const unsigned balancingThreads = tasks.size() > 1 ? 1 : analysisOptions.capital.numThreads;
+
+    // Buffers de cada thread, reaproveitados entre as componentes que ela processa; os dados temporários de
+    // cada componente (rede de fluxo, cursores do Hierholzer) vêm da arena da thread, esvaziada ao fim dela
+    std::vector<Subgraph> subgraphBuffers(workers);
+    std::vector<Arena> arenas(workers);
+
+    parallelFor(workers, tasks.size(), 1, [&](unsigned thread, size_t begin, size_t end) {
+        Subgraph& subgraph = subgraphBuffers[thread];
+        Arena& arena = arenas[thread];
+
+        for (size_t task = begin; task < end; ++task) {
+            const uint32_t c = keys[tasks[task]].second;
+            const auto& component = result.components[c];
+            CachedRoute& cached = routeCache[c];
+            cached.stats = PatrolStats();
+            std::vector<int> balance;
+            {
+                INSTRUMENT_TASK("subgraph");
+                generateSubgraph(graph, component, result, subgraph);
+                balance = EulerianCycle::calculateBalance(subgraph);
+            }
+
+            uint64_t unbalanced = 0, units = 0;
+            for (int value : balance) {
+                if (value != 0) {
+                    ++unbalanced;
+                }
+                if (value > 0) {
+                    units += static_cast<uint64_t>(value);
+                }
+            }
 
-        if (startNode.empty()) {
-            startNode = component.front();
+            if (unbalanced != 0) {
+                INSTRUMENT_TASK("balancing");
+                // O emparelhamento monta uma matriz de custos de unidades x unidades; o fluxo, nenhuma
+                BalancingMode balancing = analysisOptions.balancing;
+                if (balancing != BalancingMode::MinCostFlow && !MemoryBudget::fits(budget, units * units * sizeof(int))) {
+                    balancing = BalancingMode::MinCostFlow;
+                    INSTRUMENT_COUNT(CompactFallbacks, 1);
+                }
+                cached.stats.balancedComponents++;
+                cached.stats.unbalancedVertices += unbalanced;
+                cached.stats.extraDistance += EulerianCycle::transformToEulerian(subgraph, balance, balancing,
+                                                                                 balancingThreads, &arena);
+            }
+
+            // Traduz os identificadores locais para os globais no próprio buffer do ciclo
+            {
+                INSTRUMENT_TASK("hierholzer");
+                cached.startNode = startOf[c];
+                cached.route = EulerianCycle::findCycleFromStart(subgraph, result.localIndex[cached.startNode], &arena);
+                for (uint32_t& node : cached.route) {
+                    node = component[node];
+                }
+            }
+            arena.reset();
+            cached.valid = true;
+            INSTRUMENT_COUNT(RoutesComputed, 1);
+            ready[tasks[task]].store(true);
+            emitReady();
         }
+    });
+
+    // Entrega final, já sem concorrência: o que nenhuma thread conseguiu entregar durante o cálculo
+    for (size_t position = nextToEmit.load(); position < keys.size(); ++position) {
+        deliver(position);
+    }
+    for (const Arena& arena : arenas) {
+        INSTRUMENT_COUNT(ArenaBytes, arena.bytesServed());
+    }
 
-        auto cycle = EulerianCycle::findCycleFromStart(subgraph, startNode);
-        if (!cycle.empty()) {
-            routes.push_back(cycle);
+    // Junção determinística: contadores somados na ordem das componentes
+    for (uint32_t c = 0; c < result.components.size(); ++c) {
+        if (startOf[c] != NO_VERTEX) {
+            lastPatrolStats.balancedComponents += routeCache[c].stats.balancedComponents;
+            lastPatrolStats.unbalancedVertices += routeCache[c].stats.unbalancedVertices;
+            lastPatrolStats.extraDistance += routeCache[c].stats.extraDistance;
         }
     }
+}
 
-    sortRoutes(routes);
-    return routes;
+// Retorna as componentes fortemente conectadas com os nomes dos centros urbanos
+std::vector<std::vector<std::string>> Graph::findConnectedComponents() {
+    std::vector<std::vector<std::string>> result;
+    for (const auto& component : analysis().components) {
+        result.push_back(toNames(component));
+    }
+    return result;
 }
 
-// Gera um subgrafo contendo apenas os nós e arestas de um conjunto de vértices
-std::unordered_map<std::string, std::vector<std::string>> Graph::generateSubgraph(const std::vector<std::string>& vertices) {
-    std::unordered_map<std::string, std::vector<std::string>> subgraph;
-    for (const auto& vertex : vertices) {
-        if (adjacencyList.find(vertex) != adjacencyList.end()) {
-            subgraph[vertex] = {};
-            for (const auto& neighbor : adjacencyList[vertex]) {
-                if (contains(vertices, neighbor)) {
-                    subgraph[vertex].push_back(neighbor);
-                }
+// Gera o subgrafo de uma componente com identificadores locais, reaproveitando as listas de subgraph. Os
+// rótulos e as posições locais vêm da análise, então a extração só lê (e pode rodar em paralelo) e custa
+// O(|C| + arestas de saída de C), somando O(V + E) para todas as componentes
+void Graph::generateSubgraph(const CSRGraph& graph, const std::vector<uint32_t>& vertices,
+                             const GraphAnalysis& result, Subgraph& subgraph) const {
+    subgraph.resize(vertices.size());
+    for (uint32_t local = 0; local < vertices.size(); ++local) {
+        const uint32_t component = result.componentOf[vertices[local]];
+        std::vector<uint32_t>& adjacency = subgraph[local];
+        adjacency.clear();
+        adjacency.reserve(graph.outDegree(vertices[local]));
+        for (uint32_t neighbor : graph.neighbors(vertices[local])) {
+            if (result.componentOf[neighbor] == component) {
+                adjacency.push_back(result.localIndex[neighbor]);
             }
         }
     }
-    return subgraph;
 }
@@ -0,0 +1,210 @@
+#include "../include/GraphAnalysis.hpp"
+#include "../include/BreadthFirstSearch.hpp"
+#include "../include/Kosaraju.hpp"
+#include "../include/Tarjan.hpp"
+#include "../include/ParallelSCC.hpp"
+#include "../include/ShortestPaths.hpp"
+#include "../include/Instrumentation.hpp"
+#include <limits>
+#include <utility>
+
+// Distâncias BFS a partir de uma origem; vértices inalcançáveis ficam com UINT64_MAX
+std::vector<uint64_t> GraphAnalysis::bfsDistances(const CSRGraph& graph, uint32_t source) {
+    BreadthFirstSearch bfs;
+    bfs.run(graph, source);
+
+    std::vector<uint64_t> distances(graph.numVertices(), std::numeric_limits<uint64_t>::max());
+    for (uint32_t node : bfs.visited()) {
+        distances[node] = bfs.distance(node);
+    }
+    INSTRUMENT_COUNT(BfsRuns, 1);
+    INSTRUMENT_COUNT(BfsVerticesVisited, bfs.visited().size());
+    INSTRUMENT_COUNT(BfsEdgesScanned, bfs.edgesScanned());
+    return distances;
+}
+
+// Distâncias a partir de uma origem, mantendo a BFS quando todas as estradas têm o mesmo peso
+std::vector<uint64_t> GraphAnalysis::distancesFrom(const CSRGraph& graph, uint32_t source, unsigned numThreads) {
+    return graph.weighted() ? ShortestPaths::distancesFrom(graph, source, numThreads) : bfsDistances(graph, source);
+}
+
+// Constrói o grafo de condensação, mantendo apenas a primeira ocorrência de cada aresta entre componentes
+CSRGraph GraphAnalysis::buildCondensation(const CSRGraph& graph, const std::vector<std::vector<uint32_t>>& components,
+                                          const std::vector<uint32_t>& componentOf) {
+    const uint32_t numComponents = static_cast<uint32_t>(components.size());
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    std::vector<uint32_t> lastSeen(numComponents, std::numeric_limits<uint32_t>::max());
+
+    // Percorre as arestas agrupadas pela componente de origem para detectar repetições com um único marcador
+    for (uint32_t c = 0; c < numComponents; ++c) {
+        for (uint32_t node : components[c]) {
+            for (uint32_t neighbor : graph.neighbors(node)) {
+                uint32_t target = componentOf[neighbor];
+                if (target != c && lastSeen[target] != c) {
+                    lastSeen[target] = c;
+                    edges.emplace_back(c, target);
+                }
+            }
+        }
+    }
+    return CSRGraph(numComponents, edges);
+}
+
+// Decompõe o grafo em componentes e renumera os rótulos na forma canônica
+void GraphAnalysis::decompose(const CSRGraph& graph, SCCAlgorithm algorithm, unsigned numThreads,
+                              std::vector<std::vector<uint32_t>>& components, std::vector<uint32_t>& componentOf) {
+    uint32_t numComponents = 0;
+
+    switch (algorithm) {
+        case SCCAlgorithm::Kosaraju:
+            numComponents = Kosaraju::labelComponents(graph, componentOf);
+            break;
+        case SCCAlgorithm::Tarjan:
+            numComponents = Tarjan::labelComponents(graph, componentOf);
+            break;
+        case SCCAlgorithm::Parallel:
+            numComponents = ParallelSCC::labelComponents(graph, numThreads, componentOf);
+            break;
+    }
+
+    canonicalize(numComponents, componentOf, components);
+}
+
+// Renumera as componentes pela ordem de aparição do seu menor vértice e agrupa os membros em ordem crescente
+void GraphAnalysis::canonicalize(uint32_t numLabels, std::vector<uint32_t>& componentOf,
+                                 std::vector<std::vector<uint32_t>>& components) {
+    std::vector<uint32_t> canonical(numLabels, std::numeric_limits<uint32_t>::max());
+    components.clear();
+    for (uint32_t node = 0; node < componentOf.size(); ++node) {
+        uint32_t& label = canonical[componentOf[node]];
+        if (label == std::numeric_limits<uint32_t>::max()) {
+            label = static_cast<uint32_t>(components.size());
+            components.emplace_back();
+        }
+        componentOf[node] = label;
+        components[label].push_back(node);
+    }
+}
+
+// Executa toda a análise uma única vez
+GraphAnalysis GraphAnalysis::compute(const CSRGraph& graph, const std::vector<std::string>& names,
+                                     const AnalysisOptions& options) {
+    INSTRUMENT_STAGE("analysis");
+    GraphAnalysis analysis;
+    const uint32_t numVertices = graph.numVertices();
+
+    // Passo 1: Componentes fortemente conectadas, rótulos e condensação
+    {
+        INSTRUMENT_STAGE("scc");
+        decompose(graph, options.sccAlgorithm, options.capital.numThreads, analysis.components,
+                  analysis.componentOf);
+    }
+    {
+        INSTRUMENT_STAGE("condensation");
+        analysis.indexComponents(graph);
+    }
+
+    // Passo 2: Capital, reaproveitando as componentes na busca podada
+    {
+        INSTRUMENT_STAGE("capital");
+        if (options.capital.mode == CapitalMode::Pruned) {
+            analysis.capital = CapitalFinder::findCapitalPruned(graph, names, analysis.components,
+                                                                analysis.componentOf, &analysis.capitalStats,
+                                                                &analysis.capitalBounds);
+        } else if (options.capital.mode == CapitalMode::Approximate) {
+            analysis.capital = CapitalFinder::findCapitalApproximate(graph, names, analysis.components,
+                                                                     analysis.componentOf, options.capital,
+                                                                     &analysis.capitalStats);
+        } else {
+            analysis.capital = CapitalFinder::findCapital(graph, names, options.capital, &analysis.capitalStats);
+        }
+    }
+
+    // Passo 3: Distâncias a partir da capital
+    analysis.weightedDistances = graph.weighted();
+    {
+        INSTRUMENT_STAGE("capitalDistances");
+        if (analysis.capital != std::numeric_limits<uint32_t>::max()) {
+            analysis.capitalDistances = distancesFrom(graph, analysis.capital, options.capital.numThreads);
+        } else {
+            analysis.capitalDistances.assign(numVertices, std::numeric_limits<uint64_t>::max());
+        }
+    }
+
+    // Passo 4: Batalhões secundários
+    {
+        INSTRUMENT_STAGE("battalions");
+        analysis.placeBattalions(options.battalions, names);
+    }
+    return analysis;
+}
+
+// Reconstrói a análise a partir de rótulos canônicos: os membros de cada componente são agrupados em
+// ordem crescente, exatamente como decompose os deixaria
+GraphAnalysis GraphAnalysis::restore(const CSRGraph& graph, const std::vector<std::string>& names,
+                                     std::vector<uint32_t> componentOf, uint32_t capital,
+                                     std::vector<uint64_t> capitalDistances, BattalionMode battalions) {
+    GraphAnalysis analysis;
+    analysis.componentOf = std::move(componentOf);
+    analysis.capital = capital;
+    analysis.capitalDistances = std::move(capitalDistances);
+    analysis.weightedDistances = graph.weighted();
+
+    for (uint32_t node = 0; node < graph.numVertices(); ++node) {
+        uint32_t label = analysis.componentOf[node];
+        if (label >= analysis.components.size()) {
+            analysis.components.resize(label + 1);
+        }
+        analysis.components[label].push_back(node);
+    }
+    analysis.indexComponents(graph);
+    analysis.placeBattalions(battalions, names);
+    return analysis;
+}
+
+// Constrói a condensação e a posição de cada vértice dentro da sua componente
+void GraphAnalysis::indexComponents(const CSRGraph& graph) {
+    condensation = buildCondensation(graph, components, componentOf);
+    localIndex.assign(graph.numVertices(), 0);
+    for (const auto& component : components) {
+        for (uint32_t local = 0; local < component.size(); ++local) {
+            localIndex[component[local]] = local;
+        }
+    }
+}
+
+// Posiciona os batalhões por componente. Em cada componente sem a capital, o batalhão é o vértice mais próximo
+// dela: uma única passada pelos vértices reduz as distâncias ao mínimo de cada rótulo (o menor nome nos empates,
+// como na escolha da capital, para que o resultado não dependa da ordem de inserção dos centros). No modo dos
+// sumidouros, só as componentes sem estradas de saída na condensação mantêm o batalhão: todo centro alcança um
+// sumidouro, e de um sumidouro sem a capital não há como voltar a ela
+void GraphAnalysis::placeBattalions(BattalionMode mode, const std::vector<std::string>& names) {
+    const uint32_t none = std::numeric_limits<uint32_t>::max();
+    const uint32_t numComponents = static_cast<uint32_t>(components.size());
+    const uint32_t capitalComponent = capital != none ? componentOf[capital] : none;
+
+    componentBattalion.assign(numComponents, none);
+    std::vector<uint64_t> closest(numComponents, std::numeric_limits<uint64_t>::max());
+    for (uint32_t node = 0; node < componentOf.size(); ++node) {
+        const uint32_t c = componentOf[node];
+        const uint64_t distance = capitalDistances[node];
+        if (distance < closest[c] ||
+            (distance == closest[c] && distance != std::numeric_limits<uint64_t>::max() &&
+             names[node] < names[componentBattalion[c]])) {
+            closest[c] = distance;
+            componentBattalion[c] = node;
+        }
+    }
+
+    secondaryBattalions.clear();
+    for (uint32_t c = 0; c < numComponents; ++c) {
+        if (mode == BattalionMode::SinkComponents && condensation.outDegree(c) != 0) {
+            componentBattalion[c] = none;
+        } else if (c != capitalComponent) {
+            secondaryBattalions.push_back(componentBattalion[c]);
+        }
+    }
+    if (capitalComponent != none) {
+        componentBattalion[capitalComponent] = capital;
+    }
+}
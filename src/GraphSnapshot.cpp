@@ -0,0 +1,288 @@
+#include "../include/GraphSnapshot.hpp"
+#include "../include/EdgeListLoader.hpp"
+#include "../include/Instrumentation.hpp"
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <memory>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+// Cabeçalho de 80 bytes no início do arquivo. As seções vêm em seguida, nesta ordem e cada uma completada
+// com zeros até um múltiplo de 8 bytes: deslocamentos dos nomes (uint64, n + 1), caracteres dos nomes,
+// offsets, targets, reverseOffsets e reverseTargets da CSR (uint32), com HAS_WEIGHTS os pesos das estradas
+// (uint32, alinhados com targets) e, com HAS_ANALYSIS, componentOf (uint32, n) e capitalDistances (uint64, n)
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder; // BYTE_ORDER_MARK na ordem de bytes de quem gravou
+    uint32_t numVertices;
+    uint32_t flags;
+    uint64_t numEdges;
+    uint64_t nameBytes;
+    uint32_t capital;
+    uint32_t capitalMode; // CapitalMode com que a análise foi calculada
+    uint64_t payloadSize;
+    uint64_t checksum; // Sobre todo o conteúdo após o cabeçalho
+    uint32_t sccAlgorithm;   // SCCAlgorithm com que a análise foi calculada
+    uint32_t approxSamples;  // Pivôs e candidatos verificados do modo aproximado
+    uint32_t approxVerified;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(SnapshotHeader) == 80, "cabeçalho do snapshot deve ter 80 bytes");
+
+static constexpr char SNAPSHOT_MAGIC[8] = {'G', 'G', 'S', 'N', 'A', 'P', 0, 0};
+static constexpr uint32_t SNAPSHOT_VERSION = 3; // 2: pesos e distâncias em 64 bits; 3: opções da análise
+static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+static constexpr uint32_t HAS_ANALYSIS = 1;
+static constexpr uint32_t HAS_WEIGHTS = 2;
+
+// Tamanho de uma seção já completada até múltiplo de 8 bytes
+static uint64_t padded(uint64_t bytes) {
+    return (bytes + 7) & ~uint64_t(7);
+}
+
+// Soma de verificação palavra a palavra (8 bytes por passo); o final de cada bloco é completado com zeros,
+// como no arquivo, de modo que somar seção por seção ou o conteúdo inteiro dá o mesmo resultado
+class Checksum {
+public:
+    void update(const void* data, uint64_t bytes) {
+        const char* p = static_cast<const char*>(data);
+        for (uint64_t i = 0; i + 8 <= bytes; i += 8) {
+            uint64_t word;
+            std::memcpy(&word, p + i, sizeof(word));
+            mix(word);
+        }
+        if (bytes % 8) {
+            uint64_t word = 0;
+            std::memcpy(&word, p + (bytes - bytes % 8), bytes % 8);
+            mix(word);
+        }
+    }
+
+    uint64_t value() const { return state; }
+
+private:
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+
+    void mix(uint64_t word) {
+        state ^= word * 0xC2B2AE3D27D4EB4FULL;
+        state = ((state << 31) | (state >> 33)) * 0x9E3779B185EBCA87ULL;
+    }
+};
+
+// Grava uma seção e os zeros que a completam, acumulando a soma de verificação
+static void writeSection(std::ofstream& out, Checksum& checksum, const void* data, uint64_t bytes) {
+    static const char zeros[8] = {};
+    out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    out.write(zeros, static_cast<std::streamsize>(padded(bytes) - bytes));
+    checksum.update(data, bytes);
+}
+
+bool GraphSnapshot::write(const std::string& path, Graph& graph, bool includeAnalysis) {
+    INSTRUMENT_STAGE("snapshotWrite");
+    const CSRGraph& csr = graph.csr();
+    const uint32_t numVertices = csr.numVertices();
+    const uint64_t numEdges = csr.numEdges();
+
+    // Nomes concatenados e o deslocamento de cada um
+    std::vector<uint64_t> nameOffsets(numVertices + 1, 0);
+    std::string nameChars;
+    for (uint32_t v = 0; v < numVertices; ++v) {
+        nameChars += graph.nameOf(v);
+        nameOffsets[v + 1] = nameChars.size();
+    }
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.numVertices = numVertices;
+    header.numEdges = numEdges;
+    header.nameBytes = nameChars.size();
+    header.capital = Graph::NO_VERTEX;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header)); // Regravado ao final
+
+    Checksum checksum;
+    const CSRArrays& arrays = csr.arrays();
+    const uint64_t offsetBytes = (uint64_t(numVertices) + 1) * sizeof(uint32_t);
+    const uint64_t targetBytes = numEdges * sizeof(uint32_t);
+    writeSection(out, checksum, nameOffsets.data(), nameOffsets.size() * sizeof(uint64_t));
+    writeSection(out, checksum, nameChars.data(), nameChars.size());
+    writeSection(out, checksum, arrays.offsets, offsetBytes);
+    writeSection(out, checksum, arrays.targets, targetBytes);
+    writeSection(out, checksum, arrays.reverseOffsets, offsetBytes);
+    writeSection(out, checksum, arrays.reverseTargets, targetBytes);
+    uint64_t payloadSize = padded(nameOffsets.size() * sizeof(uint64_t)) + padded(nameChars.size()) +
+                           2 * padded(offsetBytes) + 2 * padded(targetBytes);
+    if (csr.weighted()) {
+        writeSection(out, checksum, arrays.weights, targetBytes);
+        payloadSize += padded(targetBytes);
+        header.flags |= HAS_WEIGHTS;
+    }
+
+    if (includeAnalysis) {
+        const GraphAnalysis& analysis = graph.analysis();
+        const uint64_t labelBytes = uint64_t(numVertices) * sizeof(uint32_t);
+        const uint64_t distanceBytes = uint64_t(numVertices) * sizeof(uint64_t);
+        writeSection(out, checksum, analysis.componentOf.data(), labelBytes);
+        writeSection(out, checksum, analysis.capitalDistances.data(), distanceBytes);
+        payloadSize += padded(labelBytes) + padded(distanceBytes);
+        header.flags |= HAS_ANALYSIS;
+        header.capital = analysis.capital;
+        const AnalysisOptions& options = graph.currentAnalysisOptions();
+        header.capitalMode = static_cast<uint32_t>(options.capital.mode);
+        header.sccAlgorithm = static_cast<uint32_t>(options.sccAlgorithm);
+        header.approxSamples = options.capital.samples;
+        header.approxVerified = options.capital.verified;
+    }
+
+    header.payloadSize = payloadSize;
+    header.checksum = checksum.value();
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return static_cast<bool>(out.flush());
+}
+
+// Percorre o conteúdo mapeado seção por seção, verificando que cada uma cabe no arquivo
+class SectionReader {
+public:
+    SectionReader(const char* begin, const char* end) : position(begin), limit(end) {}
+
+    template <typename T>
+    const T* take(uint64_t count) {
+        const uint64_t remaining = static_cast<uint64_t>(limit - position);
+        if (count > remaining / sizeof(T) || padded(count * sizeof(T)) > remaining) {
+            return nullptr;
+        }
+        const T* section = reinterpret_cast<const T*>(position);
+        position += padded(count * sizeof(T));
+        return section;
+    }
+
+private:
+    const char* position;
+    const char* limit;
+};
+
+// Deslocamentos de uma CSR: começam em 0, não decrescem e terminam em numEdges
+static bool validOffsets(const uint32_t* offsets, uint32_t numVertices, uint64_t numEdges) {
+    if (offsets[0] != 0 || offsets[numVertices] != numEdges) {
+        return false;
+    }
+    for (uint32_t v = 0; v < numVertices; ++v) {
+        if (offsets[v] > offsets[v + 1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Todos os valores abaixo de bound (identificadores de vértice ou de componente)
+static bool allBelow(const uint32_t* values, uint64_t count, uint32_t bound) {
+    for (uint64_t i = 0; i < count; ++i) {
+        if (values[i] >= bound) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool GraphSnapshot::load(const std::string& path, Graph& graph) {
+    INSTRUMENT_STAGE("snapshotLoad");
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    auto input = std::make_shared<InputBuffer>(fd); // O mapeamento sobrevive ao fechamento do descritor
+    close(fd);
+    if (!input->good()) {
+        return false;
+    }
+
+    // Cabeçalho: identificação, versão, ordem de bytes e tamanho do conteúdo
+    const uint64_t fileSize = static_cast<uint64_t>(input->end() - input->begin());
+    SnapshotHeader header;
+    if (fileSize < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, input->begin(), sizeof(header));
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != SNAPSHOT_VERSION || header.byteOrder != BYTE_ORDER_MARK ||
+        header.numVertices == Graph::NO_VERTEX || header.payloadSize != fileSize - sizeof(header)) {
+        return false;
+    }
+
+    // Soma de verificação sobre todo o conteúdo
+    const char* payload = input->begin() + sizeof(header);
+    Checksum checksum;
+    checksum.update(payload, header.payloadSize);
+    if (checksum.value() != header.checksum) {
+        return false;
+    }
+
+    // Seções, conferindo que os índices apontam para dentro dos vetores antes de usá-los
+    const uint32_t n = header.numVertices;
+    const uint64_t m = header.numEdges;
+    const bool hasAnalysis = header.flags & HAS_ANALYSIS;
+    const bool hasWeights = header.flags & HAS_WEIGHTS;
+    SectionReader reader(payload, input->end());
+    const uint64_t* nameOffsets = reader.take<uint64_t>(uint64_t(n) + 1);
+    const char* nameChars = reader.take<char>(header.nameBytes);
+    CSRArrays arrays;
+    arrays.offsets = reader.take<uint32_t>(uint64_t(n) + 1);
+    arrays.targets = reader.take<uint32_t>(m);
+    arrays.reverseOffsets = reader.take<uint32_t>(uint64_t(n) + 1);
+    arrays.reverseTargets = reader.take<uint32_t>(m);
+    arrays.weights = hasWeights ? reader.take<uint32_t>(m) : nullptr;
+    const uint32_t* componentOf = hasAnalysis ? reader.take<uint32_t>(n) : nullptr;
+    const uint64_t* capitalDistances = hasAnalysis ? reader.take<uint64_t>(n) : nullptr;
+    if (!nameOffsets || !nameChars || !arrays.offsets || !arrays.targets || !arrays.reverseOffsets ||
+        !arrays.reverseTargets || (hasWeights && !arrays.weights) ||
+        (hasAnalysis && (!componentOf || !capitalDistances))) {
+        return false;
+    }
+    if (!validOffsets(arrays.offsets, n, m) || !validOffsets(arrays.reverseOffsets, n, m) ||
+        !allBelow(arrays.targets, m, n) || !allBelow(arrays.reverseTargets, m, n) ||
+        (hasAnalysis && (!allBelow(componentOf, n, n) || (header.capital != Graph::NO_VERTEX && header.capital >= n)))) {
+        return false;
+    }
+    if (nameOffsets[0] != 0 || nameOffsets[n] != header.nameBytes) {
+        return false;
+    }
+
+    std::vector<std::string> names;
+    names.reserve(n);
+    for (uint32_t v = 0; v < n; ++v) {
+        if (nameOffsets[v] > nameOffsets[v + 1]) {
+            return false;
+        }
+        names.emplace_back(nameChars + nameOffsets[v], nameOffsets[v + 1] - nameOffsets[v]);
+    }
+
+    // A análise gravada só é restaurada se foi calculada com as opções desta execução; senão o grafo é
+    // analisado de novo na primeira consulta, como após a leitura do texto
+    const AnalysisOptions& options = graph.currentAnalysisOptions();
+    const bool sameOptions = header.capitalMode == static_cast<uint32_t>(options.capital.mode) &&
+                             header.sccAlgorithm == static_cast<uint32_t>(options.sccAlgorithm) &&
+                             (options.capital.mode != CapitalMode::Approximate ||
+                              (header.approxSamples == options.capital.samples &&
+                               header.approxVerified == options.capital.verified));
+    graph.loadFrozen(std::move(names), CSRGraph::view(n, m, arrays, input));
+    if (hasAnalysis && sameOptions) {
+        graph.restoreAnalysis(GraphAnalysis::restore(graph.csr(), graph.names(),
+                                                     std::vector<uint32_t>(componentOf, componentOf + n),
+                                                     header.capital,
+                                                     std::vector<uint64_t>(capitalDistances, capitalDistances + n),
+                                                     options.battalions));
+    }
+    return true;
+}
@@ -1,77 +1,238 @@
 #include "../include/HungarianAlgorithm.hpp"
+#include "../include/Instrumentation.hpp"
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <tuple>
+#include <utility>
 
-// Resolve o problema de emparelhamento perfeito de custo mínimo utilizando o Algoritmo Húngaro
-std::vector<int> HungarianAlgorithm::solve(const std::vector<std::vector<int>>& costMatrix) {
-    int numRows = costMatrix.size(); // Número de linhas na matriz de custo
-    int numCols = costMatrix[0].size(); // Número de colunas na matriz de custo
-
-    // Variáveis de dualidade para linhas e colunas
-    std::vector<int> u(numRows + 1, 0), v(numCols + 1, 0);
-
-    // Vetores para rastrear o emparelhamento e o caminho atual
-    std::vector<int> match(numCols + 1, 0), path(numCols + 1, 0);
-
-    // Itera sobre cada linha para calcular o emparelhamento de custo mínimo
-    for (int row = 1; row <= numRows; ++row) {
-        std::vector<int> minValues(numCols + 1, std::numeric_limits<int>::max());
-        std::vector<bool> visited(numCols + 1, false);
-        int col0 = 0; // Começa pela coluna fictícia
-        match[0] = row; // Emparelha a coluna fictícia com a linha atual
-
-        // Processo iterativo para melhorar o emparelhamento
-        do {
-            visited[col0] = true;
-            int currentRow = match[col0];
-            int minDelta = std::numeric_limits<int>::max();
-            int nextCol = 0;
-
-            // Atualiza os valores mínimos para colunas ainda não visitadas
-            for (int col = 1; col <= numCols; ++col) {
-                if (!visited[col]) {
-                    int currentCost = costMatrix[currentRow - 1][col - 1] - u[currentRow] - v[col];
-
-                    // Atualiza o menor custo e rastreia o caminho
-                    if (currentCost < minValues[col]) {
-                        minValues[col] = currentCost;
-                        path[col] = col0;
-                    }
+// Zera as variáveis de dualidade e o emparelhamento, reaproveitando a memória das chamadas anteriores
+void HungarianAlgorithm::resetDuals(size_t numRows, size_t numCols) {
+    rowPotential.assign(numRows, 0);
+    colPotential.assign(numCols, 0);
+    colForRow.assign(numRows, -1);
+    rowForCol.assign(numCols, -1);
+    path.assign(numCols, -1);
+    pathCost.assign(numCols, INFINITE_COST);
+    done.assign(numCols, false);
+}
 
-                    // Determina a próxima coluna com o menor delta
-                    if (minValues[col] < minDelta) {
-                        minDelta = minValues[col];
-                        nextCol = col;
-                    }
+// Ajusta as variáveis de dualidade das linhas e colunas visitadas e inverte o caminho aumentante até sink
+void HungarianAlgorithm::updateDualsAndAugment(uint32_t currentRow, int64_t minValue, int sink) {
+    INSTRUMENT_COUNT(HungarianAugmentations, 1);
+    rowPotential[currentRow] += minValue;
+    for (uint32_t row : visitedRows) {
+        if (row != currentRow) {
+            rowPotential[row] += minValue - pathCost[colForRow[row]];
+        }
+    }
+    for (uint32_t col : doneCols) {
+        colPotential[col] -= minValue - pathCost[col];
+    }
+
+    int col = sink;
+    for (;;) {
+        int row = path[col];
+        rowForCol[col] = row;
+        std::swap(colForRow[row], col);
+        if (row == static_cast<int>(currentRow)) {
+            break;
+        }
+    }
+}
+
+// Caminhos aumentantes mínimos linha a linha (numRows <= numCols). As colunas ainda não fixadas ficam
+// compactadas no início de remaining, de modo que cada varredura percorre um intervalo contíguo
+std::vector<int> HungarianAlgorithm::solveDense(const CostMatrix& costMatrix) {
+    const size_t numRows = costMatrix.numRows;
+    const size_t numCols = costMatrix.numCols;
+    resetDuals(numRows, numCols);
+    remaining.resize(numCols);
+
+    for (uint32_t currentRow = 0; currentRow < numRows; ++currentRow) {
+        for (size_t k = 0; k < numCols; ++k) {
+            remaining[k] = static_cast<uint32_t>(numCols - 1 - k);
+        }
+        std::fill(pathCost.begin(), pathCost.end(), INFINITE_COST);
+        visitedRows.clear();
+        doneCols.clear();
+
+        size_t numRemaining = numCols;
+        int64_t minValue = 0;
+        uint32_t row = currentRow;
+        int sink = -1;
+
+        while (sink == -1) {
+            visitedRows.push_back(row);
+            const int* rowCosts = costMatrix.row(row);
+            const int64_t base = minValue - rowPotential[row];
+
+            // Relaxa as colunas restantes e escolhe a de menor custo de caminho (preferindo colunas livres)
+            int64_t lowest = INFINITE_COST;
+            size_t lowestIndex = 0;
+            for (size_t k = 0; k < numRemaining; ++k) {
+                uint32_t col = remaining[k];
+                int64_t reduced = base + rowCosts[col] - colPotential[col];
+                if (reduced < pathCost[col]) {
+                    path[col] = static_cast<int>(row);
+                    pathCost[col] = reduced;
+                }
+                if (pathCost[col] < lowest || (pathCost[col] == lowest && rowForCol[col] == -1)) {
+                    lowest = pathCost[col];
+                    lowestIndex = k;
                 }
             }
 
-            // Atualiza as variáveis de dualidade e reduz os valores mínimos restantes
-            for (int col = 0; col <= numCols; ++col) {
-                if (visited[col]) {
-                    u[match[col]] += minDelta;
-                    v[col] -= minDelta;
-                } else {
-                    minValues[col] -= minDelta;
-                }
+            minValue = lowest;
+            uint32_t col = remaining[lowestIndex];
+            std::swap(remaining[lowestIndex], remaining[--numRemaining]);
+            doneCols.push_back(col);
+
+            if (rowForCol[col] == -1) {
+                sink = static_cast<int>(col);
+            } else {
+                row = static_cast<uint32_t>(rowForCol[col]);
             }
+        }
+
+        updateDualsAndAugment(currentRow, minValue, sink);
+    }
 
-            col0 = nextCol;
-        } while (match[col0] != 0); // Continua até encontrar uma coluna sem emparelhamento
+    return colForRow;
+}
 
-        // Realiza a atualização do emparelhamento
-        do {
-            int nextCol = path[col0];
-            match[col0] = match[nextCol];
-            col0 = nextCol;
-        } while (col0 != 0);
+// Resolve o emparelhamento perfeito de custo mínimo sobre a matriz densa
+std::vector<int> HungarianAlgorithm::solve(const CostMatrix& costMatrix) {
+    const size_t numRows = costMatrix.numRows;
+    const size_t numCols = costMatrix.numCols;
+    if (numRows == 0 || numCols == 0) {
+        return std::vector<int>(numRows, -1);
+    }
+    if (numRows <= numCols) {
+        return solveDense(costMatrix);
     }
 
-    // Constrói o resultado com o emparelhamento final
+    // Mais linhas que colunas: resolve a transposta e inverte o emparelhamento
+    CostMatrix transposed(numCols, numRows);
+    for (size_t r = 0; r < numRows; ++r) {
+        const int* rowCosts = costMatrix.row(r);
+        for (size_t c = 0; c < numCols; ++c) {
+            transposed(c, r) = rowCosts[c];
+        }
+    }
+    std::vector<int> rowForTransposed = solveDense(transposed);
     std::vector<int> result(numRows, -1);
-    for (int col = 1; col <= numCols; ++col) {
-        if (match[col] != 0) {
-            result[match[col] - 1] = col - 1;
+    for (size_t c = 0; c < numCols; ++c) {
+        if (rowForTransposed[c] != -1) {
+            result[rowForTransposed[c]] = static_cast<int>(c);
         }
     }
-
     return result;
 }
+
+// Mesmo algoritmo sobre a matriz esparsa: cada passo relaxa apenas as entradas da linha atual e a próxima
+// coluna sai de um heap, então o custo por linha depende das entradas visitadas e não do número de colunas
+std::vector<int> HungarianAlgorithm::solve(const SparseCostMatrix& costMatrix) {
+    const size_t numRows = costMatrix.numRows;
+    const size_t numCols = costMatrix.numCols;
+    resetDuals(numRows, numCols);
+    if (numRows == 0 || numCols == 0) {
+        return colForRow;
+    }
+
+    // Chave do heap: custo do caminho, coluna já emparelhada (livres primeiro) e índice da coluna
+    using Entry = std::tuple<int64_t, int, uint32_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+    std::vector<uint32_t> touched;
+
+    for (uint32_t currentRow = 0; currentRow < numRows; ++currentRow) {
+        visitedRows.clear();
+        doneCols.clear();
+        touched.clear();
+        heap = decltype(heap)();
+
+        int64_t minValue = 0;
+        uint32_t row = currentRow;
+        int sink = -1;
+
+        while (sink == -1) {
+            visitedRows.push_back(row);
+            const int64_t base = minValue - rowPotential[row];
+            for (size_t e = costMatrix.rowOffsets[row]; e < costMatrix.rowOffsets[row + 1]; ++e) {
+                uint32_t col = costMatrix.columns[e];
+                if (done[col]) {
+                    continue;
+                }
+                int64_t reduced = base + costMatrix.costs[e] - colPotential[col];
+                if (reduced < pathCost[col]) {
+                    if (pathCost[col] == INFINITE_COST) {
+                        touched.push_back(col);
+                    }
+                    path[col] = static_cast<int>(row);
+                    pathCost[col] = reduced;
+                    heap.emplace(reduced, rowForCol[col] == -1 ? 0 : 1, col);
+                }
+            }
+
+            // Descarta entradas obsoletas do heap
+            while (!heap.empty() && (done[std::get<2>(heap.top())] ||
+                                     std::get<0>(heap.top()) != pathCost[std::get<2>(heap.top())])) {
+                heap.pop();
+            }
+            if (heap.empty()) {
+                break; // Nenhum caminho aumentante usando apenas as entradas candidatas
+            }
+
+            uint32_t col = std::get<2>(heap.top());
+            heap.pop();
+            minValue = pathCost[col];
+            done[col] = true;
+            doneCols.push_back(col);
+
+            if (rowForCol[col] == -1) {
+                sink = static_cast<int>(col);
+            } else {
+                row = static_cast<uint32_t>(rowForCol[col]);
+            }
+        }
+
+        if (sink != -1) {
+            updateDualsAndAugment(currentRow, minValue, sink);
+        }
+
+        // Restaura apenas as colunas tocadas nesta linha
+        for (uint32_t col : touched) {
+            pathCost[col] = INFINITE_COST;
+            done[col] = false;
+        }
+    }
+
+    return colForRow;
+}
+
+// Seleciona as colunas mais baratas de cada linha com nth_element, reaproveitando o buffer de índices
+SparseCostMatrix HungarianAlgorithm::cheapestCandidates(const CostMatrix& costMatrix, size_t candidatesPerRow) {
+    SparseCostMatrix sparse;
+    sparse.numCols = costMatrix.numCols;
+    const size_t kept = std::min(candidatesPerRow, costMatrix.numCols);
+    sparse.columns.reserve(costMatrix.numRows * kept);
+    sparse.costs.reserve(costMatrix.numRows * kept);
+
+    std::vector<uint32_t> order(costMatrix.numCols);
+    for (size_t r = 0; r < costMatrix.numRows; ++r) {
+        const int* rowCosts = costMatrix.row(r);
+        for (uint32_t c = 0; c < order.size(); ++c) {
+            order[c] = c;
+        }
+        auto cheaper = [rowCosts](uint32_t a, uint32_t b) {
+            return rowCosts[a] != rowCosts[b] ? rowCosts[a] < rowCosts[b] : a < b;
+        };
+        std::nth_element(order.begin(), order.begin() + kept, order.end(), cheaper);
+        std::sort(order.begin(), order.begin() + kept);
+        for (size_t k = 0; k < kept; ++k) {
+            sparse.addEntry(order[k], rowCosts[order[k]]);
+        }
+        sparse.endRow();
+    }
+    return sparse;
+}
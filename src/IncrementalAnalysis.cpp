@@ -0,0 +1,317 @@
+#include "../include/IncrementalAnalysis.hpp"
+#include "../include/CapitalFinder.hpp"
+#include "../include/Tarjan.hpp"
+#include "../include/Instrumentation.hpp"
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+static constexpr uint64_t UNREACHED = std::numeric_limits<uint64_t>::max();
+
+// Fila de prioridade por distância usada nas correções
+using DistanceQueue = std::priority_queue<std::pair<uint64_t, uint32_t>, std::vector<std::pair<uint64_t, uint32_t>>,
+                                          std::greater<std::pair<uint64_t, uint32_t>>>;
+
+// Propaga reduções de distância a partir dos vértices já na fila (Dijkstra com pesos unitários)
+static void propagateDecreases(const CSRGraph& graph, DistanceQueue& queue, std::vector<uint64_t>& distances,
+                               const std::vector<char>* restrictTo) {
+    while (!queue.empty()) {
+        auto [distance, node] = queue.top();
+        queue.pop();
+        if (distance != distances[node]) {
+            continue;
+        }
+        for (uint32_t neighbor : graph.neighbors(node)) {
+            if ((!restrictTo || (*restrictTo)[neighbor]) && distance + 1 < distances[neighbor]) {
+                distances[neighbor] = distance + 1;
+                queue.push({distance + 1, neighbor});
+            }
+        }
+    }
+}
+
+// Correção em duas fases. Remoções: em ordem crescente de distância, um vértice cuja estrada mínima foi
+// removida perde o apoio se nenhum predecessor não afetado estiver exatamente um nível acima; os afetados
+// são recalculados a partir dos predecessores não afetados. Inserções: cada estrada nova que encurta o
+// caminho até o seu destino inicia uma propagação de reduções. Toda distância corrigida é o comprimento de um
+// caminho real e, ao final, nenhuma estrada viola a desigualdade triangular, então as distâncias são exatas
+void IncrementalAnalysis::updateDistances(const CSRGraph& graph, uint32_t source, const EdgeBatch& batch,
+                                          std::vector<uint64_t>& distances) {
+    const uint32_t numVertices = graph.numVertices();
+    distances.resize(numVertices, UNREACHED);
+    distances[source] = 0;
+
+    // Fase 1: vértices que perderam o apoio, encontrados nível a nível a partir dos destinos das remoções
+    DistanceQueue queue;
+    for (const auto& [from, to] : batch.removed) {
+        if (distances[from] != UNREACHED && distances[from] + 1 == distances[to]) {
+            queue.push({distances[to], to});
+        }
+    }
+
+    std::vector<char> checked;
+    std::vector<char> affected;
+    std::vector<uint32_t> affectedList;
+    if (!queue.empty()) {
+        checked.assign(numVertices, false);
+        affected.assign(numVertices, false);
+    }
+    while (!queue.empty()) {
+        uint32_t node = queue.top().second;
+        queue.pop();
+        if (checked[node]) {
+            continue;
+        }
+        checked[node] = true;
+
+        bool supported = false;
+        for (uint32_t predecessor : graph.reverseNeighbors(node)) {
+            if (!affected[predecessor] && distances[predecessor] != UNREACHED &&
+                distances[predecessor] + 1 == distances[node]) {
+                supported = true;
+                break;
+            }
+        }
+        if (supported) {
+            continue;
+        }
+        affected[node] = true;
+        affectedList.push_back(node);
+        for (uint32_t neighbor : graph.neighbors(node)) {
+            if (!checked[neighbor] && distances[neighbor] != UNREACHED && distances[neighbor] == distances[node] + 1) {
+                queue.push({distances[neighbor], neighbor});
+            }
+        }
+    }
+
+    // Recalcula os afetados a partir dos predecessores não afetados e propaga apenas entre eles
+    for (uint32_t node : affectedList) {
+        distances[node] = UNREACHED;
+    }
+    for (uint32_t node : affectedList) {
+        for (uint32_t predecessor : graph.reverseNeighbors(node)) {
+            if (!affected[predecessor] && distances[predecessor] != UNREACHED &&
+                distances[predecessor] + 1 < distances[node]) {
+                distances[node] = distances[predecessor] + 1;
+            }
+        }
+        if (distances[node] != UNREACHED) {
+            queue.push({distances[node], node});
+        }
+    }
+    propagateDecreases(graph, queue, distances, &affected);
+
+    // Fase 2: reduções a partir das estradas inseridas
+    for (const auto& [from, to] : batch.inserted) {
+        if (distances[from] != UNREACHED && distances[from] + 1 < distances[to]) {
+            distances[to] = distances[from] + 1;
+            queue.push({distances[to], to});
+        }
+    }
+    propagateDecreases(graph, queue, distances, nullptr);
+}
+
+// Rótulos (não canônicos) das componentes do grafo alterado; retorna o número de rótulos usados. Cada
+// componente antiga sem estradas internas removidas continua fortemente conectada; as demais são divididas
+// por um Tarjan restrito aos seus vértices. Uma fusão exige um ciclo passando por uma estrada nova, então
+// os vértices fundidos são alcançáveis a partir de um destino de estrada nova e alcançam uma origem: o
+// Tarjan restrito a essa região junta exatamente as componentes que passaram a formar ciclos
+uint32_t IncrementalAnalysis::relabelComponents(const GraphAnalysis& previous, const CSRGraph& graph,
+                                                const EdgeBatch& batch, std::vector<uint32_t>& componentOf) {
+    const uint32_t numVertices = graph.numVertices();
+    const uint32_t previousVertices = static_cast<uint32_t>(previous.componentOf.size());
+    uint32_t nextLabel = static_cast<uint32_t>(previous.components.size());
+
+    componentOf = previous.componentOf;
+    componentOf.resize(numVertices);
+    for (uint32_t node = previousVertices; node < numVertices; ++node) {
+        componentOf[node] = nextLabel++;
+    }
+    std::vector<uint32_t> position(numVertices, NONE);
+
+    // Passo 1: Divide as componentes que perderam estradas internas
+    std::vector<char> split(previous.components.size(), false);
+    for (const auto& [from, to] : batch.removed) {
+        const uint32_t component = previous.componentOf[from];
+        if (from != to && component == previous.componentOf[to] && !split[component]) {
+            split[component] = true;
+            nextLabel = Tarjan::labelSubset(graph, previous.components[component], nextLabel, componentOf, position);
+        }
+    }
+
+    // Passo 2: Funde as componentes ligadas em ciclo pelas estradas novas entre componentes diferentes
+    std::vector<uint32_t> queue;
+    for (const auto& [from, to] : batch.inserted) {
+        if (componentOf[from] != componentOf[to]) {
+            queue.push_back(to);
+        }
+    }
+    if (queue.empty()) {
+        return nextLabel;
+    }
+
+    // Marca 1: alcançável a partir de um destino; marca 2: também alcança uma origem (dentro da marca 1)
+    std::vector<uint8_t> mark(numVertices, 0);
+    for (uint32_t node : queue) {
+        mark[node] = 1;
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+        for (uint32_t neighbor : graph.neighbors(queue[head])) {
+            if (!mark[neighbor]) {
+                mark[neighbor] = 1;
+                queue.push_back(neighbor);
+            }
+        }
+    }
+
+    std::vector<uint32_t> region;
+    for (const auto& [from, to] : batch.inserted) {
+        if (componentOf[from] != componentOf[to] && mark[from] == 1) {
+            mark[from] = 2;
+            region.push_back(from);
+        }
+    }
+    for (size_t head = 0; head < region.size(); ++head) {
+        for (uint32_t predecessor : graph.reverseNeighbors(region[head])) {
+            if (mark[predecessor] == 1) {
+                mark[predecessor] = 2;
+                region.push_back(predecessor);
+            }
+        }
+    }
+    return Tarjan::labelSubset(graph, region, nextLabel, componentOf, position);
+}
+
+// Escolhe a capital do grafo alterado, preenchendo capitalDistances, capitalBounds e capitalStats. Só há
+// capital com uma única componente fonte. Se a capital anterior continua nela, o lote só removeu estradas e a
+// métrica não mudou (com ou sem pesos), as somas apenas cresceram: os limites inferiores da busca anterior continuam válidos e, se nenhum deles
+// permite vencer a soma atual da capital, ela é mantida sem nenhuma BFS. Nos demais casos a busca podada é
+// refeita partindo da soma atual da capital anterior, o que descarta de imediato os candidatos distantes
+uint32_t IncrementalAnalysis::chooseCapital(const GraphAnalysis& previous, GraphAnalysis& analysis,
+                                            const CSRGraph& graph, const std::vector<std::string>& names,
+                                            const AnalysisOptions& options, const EdgeBatch& batch) {
+    const uint32_t numVertices = graph.numVertices();
+    const bool pruned = options.capital.mode == CapitalMode::Pruned;
+    analysis.weightedDistances = graph.weighted();
+
+    uint32_t sourceComponent = NONE;
+    uint32_t numSources = 0;
+    for (uint32_t c = 0; c < analysis.components.size(); ++c) {
+        if (analysis.condensation.inDegree(c) == 0) {
+            sourceComponent = c;
+            ++numSources;
+        }
+    }
+    if (numSources != 1) {
+        analysis.capitalDistances.assign(numVertices, UNREACHED);
+        return NONE;
+    }
+
+    // Distâncias da capital anterior, corrigidas apenas onde o lote as alterou (com pesos, ou se o lote mudou a
+    // métrica, recalculadas)
+    const uint32_t previousCapital = previous.capital;
+    const bool sameMetric = previous.weightedDistances == graph.weighted();
+    std::vector<uint64_t> distances;
+    uint32_t capital = NONE;
+    if (previousCapital != NONE && analysis.componentOf[previousCapital] == sourceComponent) {
+        if (graph.weighted() || !sameMetric) {
+            distances = GraphAnalysis::distancesFrom(graph, previousCapital, options.capital.numThreads);
+        } else {
+            distances = previous.capitalDistances;
+            updateDistances(graph, previousCapital, batch, distances);
+        }
+        uint64_t sum = 0;
+        for (uint64_t distance : distances) {
+            sum += distance;
+        }
+
+        bool keep = pruned && sameMetric && batch.inserted.empty() && previous.capitalBounds.size() == numVertices;
+        for (uint32_t candidate : analysis.components[sourceComponent]) {
+            if (!keep) {
+                break;
+            }
+            const uint64_t bound = previous.capitalBounds[candidate];
+            keep = candidate == previousCapital || bound > sum ||
+                   (bound == sum && names[candidate] > names[previousCapital]);
+        }
+
+        if (keep) {
+            capital = previousCapital;
+            analysis.capitalBounds = previous.capitalBounds;
+            analysis.capitalBounds[previousCapital] = sum;
+        } else if (pruned) {
+            capital = CapitalFinder::findCapitalPruned(graph, names, analysis.components, analysis.componentOf,
+                                                       &analysis.capitalStats, &analysis.capitalBounds,
+                                                       previousCapital, sum);
+        }
+    } else if (pruned) {
+        capital = CapitalFinder::findCapitalPruned(graph, names, analysis.components, analysis.componentOf,
+                                                   &analysis.capitalStats, &analysis.capitalBounds);
+    }
+    if (options.capital.mode == CapitalMode::Approximate) {
+        capital = CapitalFinder::findCapitalApproximate(graph, names, analysis.components, analysis.componentOf,
+                                                        options.capital, &analysis.capitalStats);
+    } else if (!pruned) {
+        capital = CapitalFinder::findCapital(graph, names, options.capital, &analysis.capitalStats);
+    }
+
+    if (capital != NONE && capital == previousCapital && !distances.empty()) {
+        analysis.capitalDistances = std::move(distances);
+    } else if (capital != NONE) {
+        analysis.capitalDistances = GraphAnalysis::distancesFrom(graph, capital, options.capital.numThreads);
+    } else {
+        analysis.capitalDistances.assign(numVertices, UNREACHED);
+    }
+    return capital;
+}
+
+GraphAnalysis IncrementalAnalysis::update(const GraphAnalysis& previous, const CSRGraph& graph,
+                                          const std::vector<std::string>& names, const AnalysisOptions& options,
+                                          const EdgeBatch& batch, std::vector<uint32_t>& previousComponent) {
+    INSTRUMENT_STAGE("incrementalAnalysis");
+    GraphAnalysis analysis;
+    const uint32_t previousVertices = static_cast<uint32_t>(previous.componentOf.size());
+
+    // Passo 1: Componentes, na mesma forma canônica da decomposição completa
+    uint32_t numLabels = relabelComponents(previous, graph, batch, analysis.componentOf);
+    GraphAnalysis::canonicalize(numLabels, analysis.componentOf, analysis.components);
+    analysis.indexComponents(graph);
+
+    // Passo 2: Componentes idênticas a uma anterior (mesmos vértices e nenhuma estrada interna alterada)
+    std::vector<char> touched(analysis.components.size(), false);
+    for (const auto* edges : {&batch.inserted, &batch.removed}) {
+        for (const auto& [from, to] : *edges) {
+            if (analysis.componentOf[from] == analysis.componentOf[to]) {
+                touched[analysis.componentOf[from]] = true;
+            }
+        }
+    }
+    previousComponent.assign(analysis.components.size(), NONE);
+    for (uint32_t c = 0; c < analysis.components.size(); ++c) {
+        const auto& component = analysis.components[c];
+        if (touched[c] || component.front() >= previousVertices) {
+            continue;
+        }
+        const uint32_t candidate = previous.componentOf[component.front()];
+        if (previous.components[candidate].size() != component.size()) {
+            continue;
+        }
+        bool same = true;
+        for (uint32_t node : component) {
+            if (node >= previousVertices || previous.componentOf[node] != candidate) {
+                same = false;
+                break;
+            }
+        }
+        if (same) {
+            previousComponent[c] = candidate;
+        }
+    }
+
+    // Passo 3: Capital, distâncias e batalhões
+    analysis.capital = chooseCapital(previous, analysis, graph, names, options, batch);
+    analysis.placeBattalions(options.battalions, names);
+    return analysis;
+}
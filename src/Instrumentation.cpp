@@ -0,0 +1,183 @@
+#include "../include/Instrumentation.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <sys/resource.h>
+#include <vector>
+
+std::atomic<bool> Instrumentation::active{false};
+std::atomic<uint64_t> Instrumentation::counters[Instrumentation::NUM_COUNTERS];
+std::atomic<uint64_t> Instrumentation::allocations{0};
+std::atomic<uint64_t> Instrumentation::allocatedBytes{0};
+
+#ifdef GEOGRAPH_INSTRUMENTATION
+// Contagem das alocações: o operador new global passa a somar chamadas e bytes enquanto a medição estiver ativa
+void* operator new(std::size_t size) {
+    if (Instrumentation::enabled()) {
+        Instrumentation::allocations.fetch_add(1, std::memory_order_relaxed);
+        Instrumentation::allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+    if (void* pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+#endif
+
+static const char* const COUNTER_NAMES[Instrumentation::NUM_COUNTERS] = {
+    "bfsRuns", "bfsVerticesVisited", "bfsEdgesScanned", "hungarianAugmentations",
+    "flowAugmentations", "edgesDuplicated", "hierholzerEdges", "routesComputed", "shortestPathRuns",
+    "shortestPathVerticesSettled", "shortestPathEdgesScanned", "arenaBytes", "compactFallbacks"};
+
+// Totais de uma etapa, somados entre as suas chamadas
+struct StageRecord {
+    std::string name;
+    Instrumentation::Scope scope;
+    unsigned depth;
+    uint64_t calls = 0;
+    uint64_t wallNs = 0;
+    uint64_t cpuNs = 0;
+    uint64_t allocations = 0;
+    uint64_t allocatedBytes = 0;
+    long peakRssKB = 0;
+    long peakRssGrowthKB = 0; // Quanto a etapa elevou o pico de memória residente do processo
+};
+
+static std::mutex recordsMutex;
+static std::vector<StageRecord> records;
+static thread_local unsigned stageDepth = 0;
+
+static uint64_t wallNow() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+static uint64_t cpuNow(Instrumentation::Scope scope) {
+    timespec time{};
+    clock_gettime(scope == Instrumentation::Scope::Process ? CLOCK_PROCESS_CPUTIME_ID : CLOCK_THREAD_CPUTIME_ID,
+                  &time);
+    return static_cast<uint64_t>(time.tv_sec) * 1000000000ULL + static_cast<uint64_t>(time.tv_nsec);
+}
+
+static long peakRssKB() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// Registro da etapa com esse nome, criado na primeira vez que ela começa (chamada com recordsMutex)
+static size_t recordIndex(const char* name, Instrumentation::Scope scope, unsigned depth) {
+    auto record = std::find_if(records.begin(), records.end(),
+                               [name](const StageRecord& r) { return r.name == name; });
+    if (record != records.end()) {
+        return static_cast<size_t>(record - records.begin());
+    }
+    records.push_back(StageRecord{name, scope, depth});
+    return records.size() - 1;
+}
+
+Instrumentation::Stage::Stage(const char* name, Scope scope) : scope(scope), recording(enabled()) {
+    if (!recording) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(recordsMutex);
+        record = recordIndex(name, scope, stageDepth);
+    }
+    ++stageDepth;
+    startWallNs = wallNow();
+    startCpuNs = cpuNow(scope);
+    startAllocations = allocations.load(std::memory_order_relaxed);
+    startAllocatedBytes = allocatedBytes.load(std::memory_order_relaxed);
+    startPeakRssKB = peakRssKB();
+}
+
+Instrumentation::Stage::~Stage() {
+    if (!recording) {
+        return;
+    }
+    --stageDepth;
+    const uint64_t wall = wallNow() - startWallNs;
+    const uint64_t cpu = cpuNow(scope) - startCpuNs;
+    const uint64_t allocated = allocations.load(std::memory_order_relaxed) - startAllocations;
+    const uint64_t bytes = allocatedBytes.load(std::memory_order_relaxed) - startAllocatedBytes;
+    const long rss = peakRssKB();
+
+    std::lock_guard<std::mutex> lock(recordsMutex);
+    StageRecord& totals = records[record];
+    totals.calls++;
+    totals.wallNs += wall;
+    totals.cpuNs += cpu;
+    if (scope == Scope::Process) { // Nas tarefas, as alocações das outras threads se misturariam
+        totals.allocations += allocated;
+        totals.allocatedBytes += bytes;
+        totals.peakRssGrowthKB += rss - startPeakRssKB;
+    }
+    totals.peakRssKB = std::max(totals.peakRssKB, rss);
+}
+
+void Instrumentation::writeReport(std::ostream& out) {
+    std::lock_guard<std::mutex> lock(recordsMutex);
+    out << "{\"stages\": [";
+    for (size_t i = 0; i < records.size(); ++i) {
+        const StageRecord& r = records[i];
+        out << (i ? ",\n  " : "\n  ") << "{\"name\": \"" << r.name << "\", \"scope\": \""
+            << (r.scope == Scope::Process ? "process" : "thread") << "\"";
+        if (r.scope == Scope::Process) { // Nas tarefas a profundidade depende da thread que a executou
+            out << ", \"depth\": " << r.depth;
+        }
+        out << ", \"calls\": " << r.calls << ", \"wallSeconds\": " << r.wallNs / 1e9
+            << ", \"cpuSeconds\": " << r.cpuNs / 1e9;
+        if (r.scope == Scope::Process) {
+            out << ", \"allocations\": " << r.allocations << ", \"allocatedBytes\": " << r.allocatedBytes
+                << ", \"peakRssGrowthKB\": " << r.peakRssGrowthKB;
+        }
+        out << ", \"peakRssKB\": " << r.peakRssKB << "}";
+    }
+    out << "],\n \"counters\": {";
+    for (int c = 0; c < NUM_COUNTERS; ++c) {
+        out << (c ? ", " : "") << "\"" << COUNTER_NAMES[c] << "\": " << counters[c].load(std::memory_order_relaxed);
+    }
+    out << "},\n \"allocations\": " << allocations.load(std::memory_order_relaxed)
+        << ", \"allocatedBytes\": " << allocatedBytes.load(std::memory_order_relaxed)
+        << ", \"peakRssKB\": " << peakRssKB() << "}" << std::endl;
+}
+
+bool Instrumentation::writeReport(const std::string& destination) {
+    if (destination == "-") {
+        writeReport(std::cerr);
+        return true;
+    }
+    std::ofstream out(destination);
+    if (!out) {
+        return false;
+    }
+    writeReport(out);
+    return static_cast<bool>(out);
+}
@@ -1,71 +1,79 @@
 #include "../include/Kosaraju.hpp"
-#include <stack>
-#include <unordered_map>
+#include <limits>
 
 // Encontra as componentes fortemente conectadas utilizando o algoritmo de Kosaraju
-std::vector<std::vector<std::string>> Kosaraju::findConnectedComponents(
-    const std::unordered_map<std::string, std::vector<std::string>>& adjacencyList) {
+std::vector<std::vector<uint32_t>> Kosaraju::findConnectedComponents(const CSRGraph& graph) {
+    std::vector<uint32_t> componentOf;
+    uint32_t numComponents = labelComponents(graph, componentOf);
 
-    std::unordered_map<std::string, bool> visited;
-    std::stack<std::string> order;
-    std::vector<std::vector<std::string>> components;
+    std::vector<std::vector<uint32_t>> components(numComponents);
+    for (uint32_t node = 0; node < graph.numVertices(); ++node) {
+        components[componentOf[node]].push_back(node);
+    }
+    return components;
+}
 
-    // Realiza DFS para preencher a pilha com a ordem de finalização
-    auto dfsOrder = [&](const std::string& node, auto& dfsOrderRef) -> void {
-        visited[node] = true;
-        for (const auto& neighbor : adjacencyList.at(node)) {
-            if (!visited[neighbor]) {
-                dfsOrderRef(neighbor, dfsOrderRef);
-            }
-        }
-        order.push(node);
-    };
+// Rotula as componentes com duas buscas em profundidade iterativas (pilhas explícitas, sem recursão)
+uint32_t Kosaraju::labelComponents(const CSRGraph& graph, std::vector<uint32_t>& componentOf) {
+    const uint32_t numVertices = graph.numVertices();
+    const uint32_t unassigned = std::numeric_limits<uint32_t>::max();
 
-    // Passo 1: Preenche a pilha com a ordem de finalização
-    for (const auto& pair : adjacencyList) {
-        if (!visited[pair.first]) {
-            dfsOrder(pair.first, dfsOrder);
-        }
-    }
+    std::vector<char> visited(numVertices, false);
+    std::vector<uint32_t> order;
+    order.reserve(numVertices);
 
-    // Passo 2: Obtém o grafo transposto
-    auto transposedGraph = transposeGraph(adjacencyList);
+    // Pilha de chamadas explícita: vértice e posição do próximo vizinho a explorar
+    std::vector<uint32_t> stack;
+    std::vector<uint32_t> nextEdge(numVertices, 0);
+    stack.reserve(numVertices);
 
-    // Realiza DFS no grafo transposto para encontrar componentes
-    visited.clear();
-    auto dfsComponent = [&](const std::string& node, std::vector<std::string>& component, auto& dfsComponentRef) -> void {
-        visited[node] = true;
-        component.push_back(node);
-        for (const auto& neighbor : transposedGraph[node]) {
-            if (!visited[neighbor]) {
-                dfsComponentRef(neighbor, component, dfsComponentRef);
-            }
+    // Passo 1: Preenche a ordem de finalização
+    for (uint32_t root = 0; root < numVertices; ++root) {
+        if (visited[root]) {
+            continue;
         }
-    };
+        visited[root] = true;
+        stack.push_back(root);
 
-    // Passo 3: Identifica as componentes fortemente conectadas
-    while (!order.empty()) {
-        std::string node = order.top();
-        order.pop();
-        if (!visited[node]) {
-            std::vector<std::string> component;
-            dfsComponent(node, component, dfsComponent);
-            components.push_back(component);
+        while (!stack.empty()) {
+            uint32_t node = stack.back();
+            NeighborRange neighbors = graph.neighbors(node);
+
+            if (nextEdge[node] < neighbors.size()) {
+                uint32_t neighbor = neighbors.first[nextEdge[node]++];
+                if (!visited[neighbor]) {
+                    visited[neighbor] = true;
+                    stack.push_back(neighbor);
+                }
+            } else {
+                order.push_back(node);
+                stack.pop_back();
+            }
         }
     }
 
-    return components;
-}
-
-// Transpõe o grafo (inverte as arestas)
-std::unordered_map<std::string, std::vector<std::string>> Kosaraju::transposeGraph(
-    const std::unordered_map<std::string, std::vector<std::string>>& adjacencyList) {
+    // Passo 2: Percorre a lista reversa da CSR (grafo transposto) em ordem decrescente de finalização
+    componentOf.assign(numVertices, unassigned);
+    uint32_t numComponents = 0;
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        if (componentOf[*it] != unassigned) {
+            continue;
+        }
+        componentOf[*it] = numComponents;
+        stack.push_back(*it);
 
-    std::unordered_map<std::string, std::vector<std::string>> transposed;
-    for (const auto& pair : adjacencyList) {
-        for (const auto& neighbor : pair.second) {
-            transposed[neighbor].push_back(pair.first);
+        while (!stack.empty()) {
+            uint32_t node = stack.back();
+            stack.pop_back();
+            for (uint32_t neighbor : graph.reverseNeighbors(node)) {
+                if (componentOf[neighbor] == unassigned) {
+                    componentOf[neighbor] = numComponents;
+                    stack.push_back(neighbor);
+                }
+            }
         }
+        ++numComponents;
     }
-    return transposed;
+
+    return numComponents;
 }
@@ -0,0 +1,75 @@
+#include "../include/Memory.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <fcntl.h>
+#include <new>
+#include <sys/resource.h>
+#include <unistd.h>
+
+Arena::~Arena() {
+    releaseBlocks();
+}
+
+void Arena::releaseBlocks() {
+    for (const Block& block : blocks) {
+        ::operator delete(block.data);
+    }
+    blocks.clear();
+    used = 0;
+}
+
+// Aloca no último bloco, alinhando pelo endereço; se não couber, abre um bloco com o dobro do anterior
+void* Arena::do_allocate(size_t bytes, size_t alignment) {
+    if (!blocks.empty()) {
+        const Block& block = blocks.back();
+        const uintptr_t base = reinterpret_cast<uintptr_t>(block.data);
+        const uintptr_t start = (base + used + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+        if (start + bytes <= base + block.size) {
+            used = static_cast<size_t>(start - base) + bytes;
+            served += bytes;
+            return reinterpret_cast<void*>(start);
+        }
+    }
+
+    const size_t size = std::max(blocks.empty() ? FIRST_BLOCK : 2 * blocks.back().size, bytes + alignment);
+    blocks.push_back({static_cast<std::byte*>(::operator new(size)), size});
+    used = 0;
+    return do_allocate(bytes, alignment);
+}
+
+void Arena::reset() {
+    if (blocks.size() > 1) {
+        size_t total = 0;
+        for (const Block& block : blocks) {
+            total += block.size;
+        }
+        releaseBlocks();
+        if (total <= MAX_RETAINED) {
+            blocks.push_back({static_cast<std::byte*>(::operator new(total)), total});
+        }
+    } else if (!blocks.empty() && blocks.front().size > MAX_RETAINED) {
+        releaseBlocks();
+    }
+    used = 0;
+}
+
+// Lê a memória residente de /proc/self/statm (segundo campo, em páginas) sem alocar, já que é consultada a cada
+// componente; fora do Linux, usa o pico do getrusage
+uint64_t MemoryBudget::residentBytes() {
+    const int fd = open("/proc/self/statm", O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        char buffer[128];
+        const ssize_t length = read(fd, buffer, sizeof(buffer) - 1);
+        close(fd);
+        if (length > 0) {
+            buffer[length] = '\0';
+            char* field = nullptr;
+            std::strtoull(buffer, &field, 10);
+            const uint64_t residentPages = std::strtoull(field, nullptr, 10);
+            return residentPages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+        }
+    }
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+}
@@ -0,0 +1,100 @@
+#include "../include/MinCostFlow.hpp"
+#include "../include/Instrumentation.hpp"
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+MinCostFlow::MinCostFlow(uint32_t numNodes, std::pmr::memory_resource* memory)
+    : arcs(memory), outArcs(numNodes, memory) {}
+
+// Adiciona o arco e o seu reverso residual (capacidade 0, custo oposto)
+uint32_t MinCostFlow::addArc(uint32_t from, uint32_t to, int64_t capacity, int64_t cost) {
+    uint32_t index = static_cast<uint32_t>(arcs.size());
+    arcs.push_back({to, capacity, cost});
+    arcs.push_back({from, 0, -cost});
+    outArcs[from].push_back(index);
+    outArcs[to].push_back(index + 1);
+    return index;
+}
+
+// Caminhos aumentantes sucessivos: a cada iteração, Dijkstra com custos reduzidos encontra o caminho
+// mínimo de source a sink no grafo residual e envia por ele o máximo possível
+std::pair<int64_t, int64_t> MinCostFlow::solve(uint32_t source, uint32_t sink, int64_t maxFlow) {
+    const int64_t infinity = std::numeric_limits<int64_t>::max();
+    const uint32_t numNodes = static_cast<uint32_t>(outArcs.size());
+    std::pmr::memory_resource* memory = arcs.get_allocator().resource();
+
+    std::pmr::vector<int64_t> potential(numNodes, 0, memory);
+    std::pmr::vector<int64_t> distance(numNodes, memory);
+    std::pmr::vector<uint32_t> parentArc(numNodes, memory);
+    std::pmr::vector<char> settled(numNodes, memory);
+
+    // Fila de prioridade como heap mínimo sobre um vetor, esvaziado (sem devolver a memória) a cada iteração
+    using Entry = std::pair<int64_t, uint32_t>;
+    const std::greater<Entry> later;
+    std::pmr::vector<Entry> queue(memory);
+
+    int64_t totalFlow = 0;
+    int64_t totalCost = 0;
+
+    while (totalFlow < maxFlow) {
+        distance.assign(numNodes, infinity);
+        settled.assign(numNodes, false);
+        distance[source] = 0;
+        queue.emplace_back(0, source);
+
+        // Dijkstra interrompido assim que o sink é fixado
+        while (!queue.empty()) {
+            std::pop_heap(queue.begin(), queue.end(), later);
+            auto [dist, node] = queue.back();
+            queue.pop_back();
+            if (settled[node]) {
+                continue;
+            }
+            settled[node] = true;
+            if (node == sink) {
+                break;
+            }
+            for (uint32_t index : outArcs[node]) {
+                const Arc& arc = arcs[index];
+                if (arc.capacity == 0) {
+                    continue;
+                }
+                int64_t candidate = dist + arc.cost + potential[node] - potential[arc.to];
+                if (candidate < distance[arc.to]) {
+                    distance[arc.to] = candidate;
+                    parentArc[arc.to] = index;
+                    queue.emplace_back(candidate, arc.to);
+                    std::push_heap(queue.begin(), queue.end(), later);
+                }
+            }
+        }
+        queue.clear();
+
+        if (!settled[sink]) {
+            break;
+        }
+
+        // Atualiza os potenciais limitando as distâncias à do sink, o que mantém os custos reduzidos
+        // não negativos mesmo para os vértices que o Dijkstra interrompido não chegou a fixar
+        const int64_t sinkDistance = distance[sink];
+        for (uint32_t node = 0; node < numNodes; ++node) {
+            potential[node] += std::min(distance[node], sinkDistance);
+        }
+
+        // Envia o gargalo do caminho encontrado
+        int64_t push = maxFlow - totalFlow;
+        for (uint32_t node = sink; node != source; node = arcs[parentArc[node] ^ 1].to) {
+            push = std::min(push, arcs[parentArc[node]].capacity);
+        }
+        for (uint32_t node = sink; node != source; node = arcs[parentArc[node] ^ 1].to) {
+            arcs[parentArc[node]].capacity -= push;
+            arcs[parentArc[node] ^ 1].capacity += push;
+            totalCost += push * arcs[parentArc[node]].cost;
+        }
+        totalFlow += push;
+        INSTRUMENT_COUNT(FlowAugmentations, 1);
+    }
+
+    return {totalFlow, totalCost};
+}
@@ -0,0 +1,84 @@
+#include "../include/NameTable.hpp"
+#include <functional>
+
+// Hash do conteúdo do nome (o mesmo usado por std::unordered_map<std::string, ...>)
+uint32_t NameTable::hashOf(std::string_view name) {
+    size_t hash = std::hash<std::string_view>{}(name);
+    return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+// Sonda a partir da posição do hash até achar o nome ou uma posição vazia; a tabela nunca fica cheia
+size_t NameTable::findSlot(std::string_view name, uint32_t hash, const std::vector<std::string>& names) const {
+    const size_t mask = slots.size() - 1;
+    size_t index = hash & mask;
+    while (slots[index].id != NOT_FOUND &&
+           (slots[index].hash != hash || names[slots[index].id] != name)) {
+        index = (index + 1) & mask;
+    }
+    return index;
+}
+
+uint32_t NameTable::find(std::string_view name, const std::vector<std::string>& names) const {
+    if (slots.empty()) {
+        return NOT_FOUND;
+    }
+    return slots[findSlot(name, hashOf(name), names)].id;
+}
+
+uint32_t NameTable::intern(std::string_view name, std::vector<std::string>& names) {
+    // Mantém a ocupação abaixo de 1/2 para que as sondagens continuem curtas
+    if (2 * (numEntries + 1) > slots.size()) {
+        rehash(slots.empty() ? 16 : 2 * slots.size());
+    }
+    const uint32_t hash = hashOf(name);
+    const size_t index = findSlot(name, hash, names);
+    if (slots[index].id == NOT_FOUND) {
+        slots[index] = {hash, static_cast<uint32_t>(names.size())};
+        names.emplace_back(name);
+        ++numEntries;
+    }
+    return slots[index].id;
+}
+
+void NameTable::reserve(size_t count) {
+    size_t capacity = slots.empty() ? 16 : slots.size();
+    while (capacity < 2 * count) {
+        capacity *= 2;
+    }
+    if (capacity > slots.size()) {
+        rehash(capacity);
+    }
+}
+
+void NameTable::rebuild(const std::vector<std::string>& names) {
+    slots.clear();
+    numEntries = 0;
+    reserve(names.size());
+    const size_t mask = slots.size() - 1;
+    for (uint32_t id = 0; id < names.size(); ++id) {
+        const uint32_t hash = hashOf(names[id]);
+        size_t index = hash & mask;
+        while (slots[index].id != NOT_FOUND) {
+            index = (index + 1) & mask;
+        }
+        slots[index] = {hash, id};
+    }
+    numEntries = names.size();
+}
+
+// Reinsere as entradas em uma tabela maior usando os hashes guardados, sem reler os nomes
+void NameTable::rehash(size_t capacity) {
+    std::vector<Slot> old(capacity);
+    old.swap(slots);
+    const size_t mask = capacity - 1;
+    for (const Slot& slot : old) {
+        if (slot.id == NOT_FOUND) {
+            continue;
+        }
+        size_t index = slot.hash & mask;
+        while (slots[index].id != NOT_FOUND) {
+            index = (index + 1) & mask;
+        }
+        slots[index] = slot;
+    }
+}
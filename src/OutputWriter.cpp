@@ -0,0 +1,97 @@
+#include "../include/OutputWriter.hpp"
+#include <cerrno>
+#include <cstring>
+#include <sys/uio.h>
+#include <unistd.h>
+
+OutputWriter::OutputWriter(int fd, size_t capacity) : fd(fd), buffer(capacity == 0 ? 1 : capacity) {}
+
+OutputWriter::~OutputWriter() {
+    drain();
+}
+
+void OutputWriter::write(std::string_view bytes) {
+    if (bytes.size() <= buffer.size() - used) {
+        std::memcpy(buffer.data() + used, bytes.data(), bytes.size());
+        used += bytes.size();
+        return;
+    }
+    if (bytes.size() < buffer.size()) {
+        drain();
+        std::memcpy(buffer.data(), bytes.data(), bytes.size());
+        used = bytes.size();
+        return;
+    }
+
+    // Trecho grande: pendente e trecho saem juntos, direto da memória do chamador
+    iovec parts[2] = {{buffer.data(), used}, {const_cast<char*>(bytes.data()), bytes.size()}};
+    size_t remaining = used + bytes.size();
+    iovec* part = used ? parts : parts + 1;
+    int count = used ? 2 : 1;
+    while (remaining > 0 && !failed) {
+        ssize_t written = ::writev(fd, part, count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            failed = true;
+            break;
+        }
+        remaining -= static_cast<size_t>(written);
+        // Avança sobre as partes já enviadas por inteiro e ajusta a parcialmente enviada
+        size_t advanced = static_cast<size_t>(written);
+        while (count > 0 && advanced >= part->iov_len) {
+            advanced -= part->iov_len;
+            ++part;
+            --count;
+        }
+        if (count > 0) {
+            part->iov_base = static_cast<char*>(part->iov_base) + advanced;
+            part->iov_len -= advanced;
+        }
+    }
+    used = 0;
+}
+
+void OutputWriter::writeNumber(uint64_t value) {
+    char digits[20];
+    size_t length = 0;
+    do {
+        digits[sizeof(digits) - ++length] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    write(std::string_view(digits + sizeof(digits) - length, length));
+}
+
+void OutputWriter::writeVarint(uint64_t value) {
+    while (value >= 0x80) {
+        put(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    put(static_cast<char>(value));
+}
+
+bool OutputWriter::flush() {
+    drain();
+    return !failed;
+}
+
+void OutputWriter::drain() {
+    writeAll(buffer.data(), used);
+    used = 0;
+}
+
+void OutputWriter::writeAll(const char* data, size_t size) {
+    while (size > 0 && !failed) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            failed = true;
+            break;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+}
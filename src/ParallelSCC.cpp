@@ -0,0 +1,255 @@
+#include "../include/ParallelSCC.hpp"
+#include "../include/Parallel.hpp"
+#include "../include/Tarjan.hpp"
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <utility>
+
+static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+// Vértices por bloco nas passadas paralelas; fronteiras com um único bloco rodam na thread chamadora
+static constexpr size_t CHUNK_SIZE = 1024;
+
+// Subproblemas menores que isto (ou que numVertices / (8 * threads)) são resolvidos por uma única thread
+static constexpr size_t MIN_PARALLEL_SUBPROBLEM = 4096;
+
+// Marcas da busca para frente e para trás a partir do pivô
+static constexpr uint8_t FORWARD = 1;
+static constexpr uint8_t BACKWARD = 2;
+
+// Conjunto de vértices ainda sem componente; partition[v] == id para todo v em vertices
+struct Subproblem {
+    uint32_t id;
+    std::vector<uint32_t> vertices;
+};
+
+// Estado compartilhado da decomposição: poda, divisão forward-backward e Tarjan restrito
+struct Decomposition {
+    const CSRGraph& graph;
+    const unsigned workers;
+    std::vector<uint32_t>& componentOf;
+    std::atomic<uint32_t> numComponents{0};
+
+    std::vector<uint32_t> partition;
+    std::vector<std::atomic<uint8_t>> marks;
+    std::vector<std::vector<uint32_t>> local; // Buffer de saída de cada thread
+
+    Decomposition(const CSRGraph& g, unsigned numThreads, std::vector<uint32_t>& labels)
+        : graph(g), workers(resolveThreadCount(numThreads)), componentOf(labels),
+          partition(g.numVertices(), NONE), marks(g.numVertices()), local(workers) {
+        componentOf.assign(g.numVertices(), NONE);
+    }
+
+    // Junta os buffers das threads em out, esvaziando-os
+    void gather(std::vector<uint32_t>& out) {
+        out.clear();
+        for (auto& buffer : local) {
+            out.insert(out.end(), buffer.begin(), buffer.end());
+            buffer.clear();
+        }
+    }
+
+    // Passo 1: Remove iterativamente os vértices sem entrada ou sem saída restantes, cada um uma componente trivial
+    void trim() {
+        const uint32_t numVertices = graph.numVertices();
+        std::vector<std::atomic<uint32_t>> inDegree(numVertices);
+        std::vector<std::atomic<uint32_t>> outDegree(numVertices);
+
+        // A marca FORWARD indica aqui que o vértice já foi podado (apenas uma thread o reivindica)
+        auto claim = [&](uint32_t node, unsigned thread) {
+            uint8_t expected = 0;
+            if (marks[node].compare_exchange_strong(expected, FORWARD, std::memory_order_relaxed)) {
+                local[thread].push_back(node);
+            }
+        };
+
+        parallelFor(workers, numVertices, CHUNK_SIZE, [&](unsigned thread, size_t begin, size_t end) {
+            for (size_t v = begin; v < end; ++v) {
+                uint32_t node = static_cast<uint32_t>(v);
+                inDegree[node].store(graph.inDegree(node), std::memory_order_relaxed);
+                outDegree[node].store(graph.outDegree(node), std::memory_order_relaxed);
+                if (graph.inDegree(node) == 0 || graph.outDegree(node) == 0) {
+                    claim(node, thread);
+                }
+            }
+        });
+
+        std::vector<uint32_t> frontier;
+        gather(frontier);
+        while (!frontier.empty()) {
+            parallelFor(workers, frontier.size(), CHUNK_SIZE, [&](unsigned thread, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    uint32_t node = frontier[i];
+                    componentOf[node] = numComponents.fetch_add(1, std::memory_order_relaxed);
+
+                    // Remover o vértice retira suas arestas, podendo zerar o grau de vizinhos
+                    for (uint32_t neighbor : graph.neighbors(node)) {
+                        if (inDegree[neighbor].fetch_sub(1, std::memory_order_relaxed) == 1) {
+                            claim(neighbor, thread);
+                        }
+                    }
+                    for (uint32_t neighbor : graph.reverseNeighbors(node)) {
+                        if (outDegree[neighbor].fetch_sub(1, std::memory_order_relaxed) == 1) {
+                            claim(neighbor, thread);
+                        }
+                    }
+                }
+            });
+            gather(frontier);
+        }
+    }
+
+    // BFS em níveis restrita ao subproblema, marcando com bit os vértices alcançados a partir do pivô
+    void markReachable(uint32_t pivot, uint32_t part, uint8_t bit) {
+        std::vector<uint32_t> frontier{pivot};
+        marks[pivot].fetch_or(bit, std::memory_order_relaxed);
+
+        while (!frontier.empty()) {
+            parallelFor(workers, frontier.size(), CHUNK_SIZE, [&](unsigned thread, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    NeighborRange range = bit == FORWARD ? graph.neighbors(frontier[i])
+                                                         : graph.reverseNeighbors(frontier[i]);
+                    for (uint32_t neighbor : range) {
+                        if (partition[neighbor] == part &&
+                            (marks[neighbor].load(std::memory_order_relaxed) & bit) == 0 &&
+                            (marks[neighbor].fetch_or(bit, std::memory_order_relaxed) & bit) == 0) {
+                            local[thread].push_back(neighbor);
+                        }
+                    }
+                }
+            });
+            gather(frontier);
+        }
+    }
+
+    // Passo 2: Divide um subproblema grande: a componente do pivô é a interseção dos alcançados nos dois
+    // sentidos, e os demais vértices formam três subproblemas independentes (só para frente, só para trás e o resto).
+    // Se a componente do pivô for pequena, novas divisões tendem a remover poucos vértices a um custo linear
+    // cada, então os três subproblemas vão direto para o Tarjan restrito
+    void split(Subproblem& current, size_t threshold, uint32_t& nextPartition,
+               std::vector<Subproblem>& pending, std::vector<Subproblem>& small) {
+        uint32_t pivot = current.vertices.front();
+        markReachable(pivot, current.id, FORWARD);
+        markReachable(pivot, current.id, BACKWARD);
+
+        const uint32_t label = numComponents.fetch_add(1, std::memory_order_relaxed);
+        Subproblem forwardOnly{nextPartition++, {}};
+        Subproblem backwardOnly{nextPartition++, {}};
+        Subproblem rest{current.id, {}};
+        size_t componentSize = 0;
+
+        for (uint32_t node : current.vertices) {
+            uint8_t mark = marks[node].exchange(0, std::memory_order_relaxed);
+            if (mark == (FORWARD | BACKWARD)) {
+                componentOf[node] = label;
+                partition[node] = NONE;
+                ++componentSize;
+            } else if (mark == FORWARD) {
+                partition[node] = forwardOnly.id;
+                forwardOnly.vertices.push_back(node);
+            } else if (mark == BACKWARD) {
+                partition[node] = backwardOnly.id;
+                backwardOnly.vertices.push_back(node);
+            } else {
+                rest.vertices.push_back(node);
+            }
+        }
+
+        std::vector<Subproblem>& destination = componentSize >= threshold ? pending : small;
+        for (Subproblem* part : {&forwardOnly, &backwardOnly, &rest}) {
+            if (!part->vertices.empty()) {
+                destination.push_back(std::move(*part));
+            }
+        }
+    }
+
+    // Passo 3: Resolve os subproblemas pequenos em paralelo, um por vez em cada thread, com o Tarjan restrito às
+    // arestas internas. Cada vértice pertence a um único subproblema, então as posições ficam em um único array
+    void solveSmall(std::vector<Subproblem>& small) {
+        std::vector<uint32_t> position(graph.numVertices());
+
+        // Maiores primeiro, para equilibrar a carga entre as threads
+        std::sort(small.begin(), small.end(), [](const Subproblem& a, const Subproblem& b) {
+            return a.vertices.size() > b.vertices.size();
+        });
+
+        std::vector<Tarjan::Workspace> workspaces(workers);
+        parallelFor(workers, small.size(), 1, [&](unsigned thread, size_t begin, size_t end) {
+            for (size_t s = begin; s < end; ++s) {
+                const Subproblem& sub = small[s];
+                const uint32_t size = static_cast<uint32_t>(sub.vertices.size());
+                for (uint32_t i = 0; i < size; ++i) {
+                    position[sub.vertices[i]] = i;
+                }
+
+                auto vertexAt = [&sub](uint32_t slot) { return sub.vertices[slot]; };
+                auto slotOf = [&](uint32_t vertex) {
+                    return partition[vertex] == sub.id ? position[vertex] : Tarjan::OUTSIDE;
+                };
+                auto assign = [&](const uint32_t* first, const uint32_t* last) {
+                    const uint32_t label = numComponents.fetch_add(1, std::memory_order_relaxed);
+                    for (const uint32_t* member = first; member != last; ++member) {
+                        componentOf[sub.vertices[*member]] = label;
+                    }
+                };
+                Tarjan::labelRestricted(graph, size, vertexAt, slotOf, assign, workspaces[thread]);
+            }
+        });
+    }
+};
+
+// Encontra as componentes fortemente conectadas com a decomposição paralela
+std::vector<std::vector<uint32_t>> ParallelSCC::findConnectedComponents(const CSRGraph& graph, unsigned numThreads) {
+    std::vector<uint32_t> componentOf;
+    uint32_t numComponents = labelComponents(graph, numThreads, componentOf);
+
+    std::vector<std::vector<uint32_t>> components(numComponents);
+    for (uint32_t node = 0; node < graph.numVertices(); ++node) {
+        components[componentOf[node]].push_back(node);
+    }
+    return components;
+}
+
+// Rotula as componentes: poda das triviais, divisão forward-backward dos subproblemas grandes com BFS
+// paralela e Tarjan restrito para os subproblemas pequenos, distribuídos entre as threads
+uint32_t ParallelSCC::labelComponents(const CSRGraph& graph, unsigned numThreads, std::vector<uint32_t>& componentOf) {
+    const uint32_t numVertices = graph.numVertices();
+    Decomposition state(graph, numThreads, componentOf);
+
+    state.trim();
+
+    // Os vértices que restaram formam o subproblema inicial (as marcas de poda deixam de ser usadas)
+    Subproblem remaining{0, {}};
+    for (uint32_t node = 0; node < numVertices; ++node) {
+        state.marks[node].store(0, std::memory_order_relaxed);
+        if (componentOf[node] == NONE) {
+            state.partition[node] = remaining.id;
+            remaining.vertices.push_back(node);
+        }
+    }
+
+    const size_t threshold = std::max<size_t>(MIN_PARALLEL_SUBPROBLEM, numVertices / (8 * state.workers));
+    uint32_t nextPartition = remaining.id + 1;
+    std::vector<Subproblem> pending;
+    std::vector<Subproblem> small;
+    if (!remaining.vertices.empty()) {
+        pending.push_back(std::move(remaining));
+    }
+
+    while (!pending.empty()) {
+        Subproblem current = std::move(pending.back());
+        pending.pop_back();
+        if (current.vertices.size() < threshold) {
+            small.push_back(std::move(current));
+        } else {
+            state.split(current, threshold, nextPartition, pending, small);
+        }
+    }
+
+    if (!small.empty()) {
+        state.solveSmall(small);
+    }
+
+    return state.numComponents.load();
+}
@@ -0,0 +1,332 @@
+#include "../include/QueryServer.hpp"
+#include "../include/BreadthFirstSearch.hpp"
+#include "../include/EdgeListLoader.hpp"
+#include "../include/ShortestPaths.hpp"
+#include <cerrno>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+QueryServer::QueryServer(Graph& graph) : graph(graph) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    refresh();
+}
+
+// Monta uma resposta "OK n" com as linhas dadas
+static std::string okResponse(const std::vector<std::string>& lines) {
+    std::string response = "OK " + std::to_string(lines.size()) + "\n";
+    for (const auto& line : lines) {
+        response += line;
+        response += '\n';
+    }
+    return response;
+}
+
+static std::string errorResponse(const std::string& message) {
+    return "ERR " + message + "\n";
+}
+
+// Recalcula (ou reaproveita, após uma atualização incremental) a análise, as rotas e as respostas prontas.
+// Chamada sempre com o lock exclusivo
+void QueryServer::refresh() {
+    capitalResponse = okResponse({graph.findCapital()});
+    battalionsResponse = okResponse(graph.findSecondaryBattalions());
+
+    frozen = &graph.csr();
+    analysis = &graph.analysis();
+
+    // Rota de cada componente, traduzida para nomes à medida que é entregue
+    routeResponse.assign(analysis->components.size(), okResponse({}));
+    graph.streamPatrolRoutes([this](const std::vector<uint32_t>& route) {
+        std::string line;
+        for (size_t i = 0; i < route.size(); ++i) {
+            if (i) line += ' ';
+            line += graph.nameOf(route[i]);
+        }
+        routeResponse[analysis->componentOf[route.front()]] = okResponse({line});
+    });
+}
+
+// Dijkstra que termina ao fixar o destino, com buffers por thread devolvidos ao estado inicial tocando só os
+// vértices alcançados
+static uint64_t weightedDistance(const CSRGraph& graph, uint32_t source, uint32_t target) {
+    thread_local std::vector<uint64_t> dist;
+    thread_local std::vector<uint32_t> reached;
+    thread_local RadixHeap heap;
+    if (dist.size() < graph.numVertices()) {
+        dist.assign(graph.numVertices(), ShortestPaths::UNREACHABLE);
+    }
+    heap.clear();
+    reached.clear();
+    dist[source] = 0;
+    reached.push_back(source);
+    heap.push(0, source);
+
+    uint64_t result = ShortestPaths::UNREACHABLE;
+    while (!heap.empty()) {
+        auto [distance, node] = heap.pop();
+        if (distance != dist[node]) {
+            continue;
+        }
+        if (node == target) {
+            result = distance;
+            break;
+        }
+        const uint32_t* weight = graph.neighborWeights(node);
+        for (uint32_t neighbor : graph.neighbors(node)) {
+            const uint64_t candidate = distance + *weight++;
+            if (candidate < dist[neighbor]) {
+                if (dist[neighbor] == ShortestPaths::UNREACHABLE) {
+                    reached.push_back(neighbor);
+                }
+                dist[neighbor] = candidate;
+                heap.push(candidate, neighbor);
+            }
+        }
+    }
+    for (uint32_t node : reached) {
+        dist[node] = ShortestPaths::UNREACHABLE;
+    }
+    return result;
+}
+
+// Menor distância entre dois centros (em estradas, ou pela soma dos pesos): as distâncias da capital já estão
+// calculadas; para as demais origens, BFS (ou Dijkstra) que termina ao alcançar o destino
+std::string QueryServer::distance(const std::string& from, const std::string& to) const {
+    const uint32_t source = graph.idOf(from);
+    const uint32_t target = graph.idOf(to);
+    if (source == Graph::NO_VERTEX || target == Graph::NO_VERTEX) {
+        return errorResponse("centro desconhecido");
+    }
+
+    uint64_t result = UINT64_MAX;
+    if (source == analysis->capital) {
+        result = analysis->capitalDistances[target];
+    } else if (frozen->weighted()) {
+        result = weightedDistance(*frozen, source, target);
+    } else {
+        // Buffers da thread reaproveitados entre as consultas; a busca para no nível em que o destino aparece
+        thread_local BreadthFirstSearch bfs;
+        auto untilTarget = [&](uint32_t, const uint32_t*, const uint32_t*) {
+            return bfs.distance(target) == BreadthFirstSearch::UNVISITED;
+        };
+        bfs.run(*frozen, source, BreadthFirstSearch::Direction::Forward, untilTarget);
+        if (bfs.distance(target) != BreadthFirstSearch::UNVISITED) {
+            result = bfs.distance(target);
+        }
+    }
+    return okResponse({result == UINT64_MAX ? "-1" : std::to_string(result)});
+}
+
+// Lê as alterações "+ A B [peso]" / "- A B" restantes da requisição, aplica o lote e prepara as novas respostas
+std::string QueryServer::update(std::istream& fields) {
+    std::vector<RoadUpdate> updates;
+    std::string operation;
+    bool hasOperation = static_cast<bool>(fields >> operation);
+    while (hasOperation) {
+        RoadUpdate road;
+        if ((operation != "+" && operation != "-") || !(fields >> road.from >> road.to)) {
+            return errorResponse("atualização malformada");
+        }
+        road.kind = operation == "+" ? RoadUpdate::Insert : RoadUpdate::Remove;
+
+        // Depois de uma inserção, um token que não inicia outra alteração é o peso da estrada
+        hasOperation = static_cast<bool>(fields >> operation);
+        if (hasOperation && road.kind == RoadUpdate::Insert && operation != "+" && operation != "-") {
+            if (!EdgeListLoader::parseWeight(operation, road.weight)) {
+                return errorResponse("peso inválido");
+            }
+            hasOperation = static_cast<bool>(fields >> operation);
+        }
+        updates.push_back(std::move(road));
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    const size_t applied = graph.applyUpdates(updates);
+    refresh();
+    return okResponse({std::to_string(applied)});
+}
+
+std::string QueryServer::handle(const std::string& request) {
+    std::istringstream fields(request);
+    std::string command;
+    if (!(fields >> command)) {
+        return errorResponse("requisição vazia");
+    }
+    if (command == "update") {
+        return update(fields);
+    }
+
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    if (command == "capital") {
+        return capitalResponse;
+    }
+    if (command == "battalions") {
+        return battalionsResponse;
+    }
+    if (command == "route") {
+        std::string location;
+        if (!(fields >> location)) {
+            return errorResponse("uso: route CENTRO");
+        }
+        const uint32_t id = graph.idOf(location);
+        if (id == Graph::NO_VERTEX) {
+            return errorResponse("centro desconhecido");
+        }
+        return routeResponse[analysis->componentOf[id]];
+    }
+    if (command == "distance") {
+        std::string from, to;
+        if (!(fields >> from >> to)) {
+            return errorResponse("uso: distance ORIGEM DESTINO");
+        }
+        return distance(from, to);
+    }
+    return errorResponse("comando desconhecido: " + command);
+}
+
+void QueryServer::serveStream(std::istream& in, std::ostream& out) {
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string command;
+        fields >> command;
+        if (command == "quit" || command == "shutdown") {
+            break;
+        }
+        out << handle(line) << std::flush;
+    }
+}
+
+// Envia toda a resposta; retorna false se o cliente fechou a conexão
+static bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t written = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        sent += static_cast<size_t>(written);
+    }
+    return true;
+}
+
+// Atende uma conexão: acumula os bytes recebidos e responde a cada linha completa
+void QueryServer::serveConnection(int fd) {
+    std::string pending;
+    char buffer[4096];
+    bool open = true;
+    while (open) {
+        ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            break;
+        }
+        pending.append(buffer, static_cast<size_t>(received));
+
+        size_t start = 0;
+        for (size_t end; open && (end = pending.find('\n', start)) != std::string::npos; start = end + 1) {
+            std::string line = pending.substr(start, end - start);
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            std::istringstream fields(line);
+            std::string command;
+            fields >> command;
+            if (command == "quit") {
+                open = false;
+            } else if (command == "shutdown") {
+                open = false;
+                stop();
+            } else {
+                open = sendAll(fd, handle(line));
+            }
+        }
+        pending.erase(0, start);
+    }
+
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    for (auto& connection : connections) {
+        if (connection == fd) {
+            connection = -1;
+        }
+    }
+    close(fd);
+}
+
+// Interrompe o accept e as leituras pendentes; cada thread fecha o seu próprio descritor
+void QueryServer::stop() {
+    stopping = true;
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    shutdown(listenFd, SHUT_RDWR);
+    for (int fd : connections) {
+        if (fd >= 0) {
+            shutdown(fd, SHUT_RDWR);
+        }
+    }
+}
+
+bool QueryServer::serveSocket(const std::string& path) {
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return false;
+    }
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0 || listen(fd, 64) < 0) {
+        close(fd);
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(connectionsMutex);
+        listenFd = fd;
+        stopping = false;
+    }
+
+    std::vector<std::thread> workers;
+    while (!stopping) {
+        int client = accept(fd, nullptr, nullptr);
+        if (client < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            break; // Socket de escuta interrompido por stop
+        }
+        std::lock_guard<std::mutex> lock(connectionsMutex);
+        if (stopping) {
+            close(client);
+            break;
+        }
+        connections.push_back(client);
+        workers.emplace_back(&QueryServer::serveConnection, this, client);
+    }
+
+    stop();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(connectionsMutex);
+        connections.clear();
+        listenFd = -1;
+    }
+    close(fd);
+    unlink(path.c_str());
+    return true;
+}
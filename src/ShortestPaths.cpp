@@ -0,0 +1,205 @@
+#include "../include/ShortestPaths.hpp"
+#include "../include/Parallel.hpp"
+#include "../include/Instrumentation.hpp"
+#include <algorithm>
+#include <atomic>
+#include <map>
+
+// Vértices por bloco nas passadas paralelas; fronteiras com um único bloco rodam na thread chamadora
+static constexpr size_t CHUNK_SIZE = 1024;
+
+std::pair<uint64_t, uint32_t> RadixHeap::pop() {
+    if (buckets[0].empty()) {
+        // Redistribui o primeiro balde não vazio a partir da sua menor chave, que passa a ser a última
+        unsigned first = 1;
+        while (buckets[first].empty()) {
+            ++first;
+        }
+        last = std::min_element(buckets[first].begin(), buckets[first].end())->first;
+        for (const auto& entry : buckets[first]) {
+            buckets[bucketOf(entry.first)].push_back(entry);
+        }
+        buckets[first].clear();
+    }
+    std::pair<uint64_t, uint32_t> top = buckets[0].back();
+    buckets[0].pop_back();
+    --count;
+    return top;
+}
+
+void RadixHeap::clear() {
+    for (auto& bucket : buckets) {
+        bucket.clear();
+    }
+    last = 0;
+    count = 0;
+}
+
+uint32_t ShortestPaths::dijkstra(const CSRGraph& graph, uint32_t source, std::vector<uint64_t>& distances,
+                                 RadixHeap& heap) {
+    distances.assign(graph.numVertices(), UNREACHABLE);
+    heap.clear();
+    distances[source] = 0;
+    heap.push(0, source);
+
+    // Cada vértice é empilhado apenas quando a sua distância diminui, então entradas com chave diferente da
+    // distância atual são cópias antigas
+    uint32_t settled = 0;
+    uint64_t edgesScanned = 0;
+    while (!heap.empty()) {
+        auto [distance, node] = heap.pop();
+        if (distance != distances[node]) {
+            continue;
+        }
+        ++settled;
+        edgesScanned += graph.outDegree(node);
+        const uint32_t* weight = graph.neighborWeights(node);
+        for (uint32_t neighbor : graph.neighbors(node)) {
+            const uint64_t candidate = distance + *weight++;
+            if (candidate < distances[neighbor]) {
+                distances[neighbor] = candidate;
+                heap.push(candidate, neighbor);
+            }
+        }
+    }
+    INSTRUMENT_COUNT(ShortestPathRuns, 1);
+    INSTRUMENT_COUNT(ShortestPathVerticesSettled, settled);
+    INSTRUMENT_COUNT(ShortestPathEdgesScanned, edgesScanned);
+    return settled;
+}
+
+std::vector<uint64_t> ShortestPaths::deltaStepping(const CSRGraph& graph, uint32_t source, unsigned numThreads,
+                                                   uint64_t delta) {
+    const uint32_t numVertices = graph.numVertices();
+    const unsigned workers = resolveThreadCount(numThreads);
+    if (delta == 0) {
+        uint64_t totalWeight = 0;
+        for (size_t e = 0; e < graph.numEdges(); ++e) {
+            totalWeight += graph.arrays().weights[e];
+        }
+        delta = std::max<uint64_t>(1, totalWeight / std::max<size_t>(graph.numEdges(), 1));
+    }
+
+    std::vector<std::atomic<uint64_t>> distances(numVertices);
+    parallelFor(workers, numVertices, CHUNK_SIZE, [&](unsigned, size_t begin, size_t end) {
+        for (size_t v = begin; v < end; ++v) {
+            distances[v].store(UNREACHABLE, std::memory_order_relaxed);
+        }
+    });
+    distances[source].store(0, std::memory_order_relaxed);
+
+    // Vértices cuja distância diminuiu na última passada, por thread
+    std::vector<std::vector<uint32_t>> improved(workers);
+    std::vector<uint64_t> edgesScanned(workers, 0);
+
+    // Relaxa as estradas leves ou as pesadas dos vértices dados (mínimo atômico sobre a distância do destino)
+    auto relaxEdges = [&](const std::vector<uint32_t>& vertices, bool light) {
+        parallelFor(workers, vertices.size(), CHUNK_SIZE, [&](unsigned thread, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const uint32_t node = vertices[i];
+                const uint64_t distance = distances[node].load(std::memory_order_relaxed);
+                const uint32_t* weight = graph.neighborWeights(node);
+                edgesScanned[thread] += graph.outDegree(node);
+                for (uint32_t neighbor : graph.neighbors(node)) {
+                    const uint64_t candidate = distance + *weight;
+                    if ((*weight++ <= delta) != light) {
+                        continue;
+                    }
+                    uint64_t current = distances[neighbor].load(std::memory_order_relaxed);
+                    while (candidate < current) {
+                        if (distances[neighbor].compare_exchange_weak(current, candidate, std::memory_order_relaxed)) {
+                            improved[thread].push_back(neighbor);
+                            break;
+                        }
+                    }
+                }
+            }
+        });
+    };
+
+    // Baldes não vazios pelo índice distância / delta; entradas antigas (vértice já em balde menor) são
+    // descartadas ao abrir o balde. Marcas por vértice evitam repetições na fronteira e entre os fixados
+    std::map<uint64_t, std::vector<uint32_t>> buckets;
+    buckets[0].push_back(source);
+    std::vector<uint64_t> inFrontier(numVertices, UNREACHABLE);
+    std::vector<uint64_t> settledIn(numVertices, UNREACHABLE);
+    std::vector<uint32_t> frontier, settled;
+    uint64_t round = 0;
+    uint64_t numSettled = 0;
+
+    while (!buckets.empty()) {
+        const uint64_t index = buckets.begin()->first;
+        std::vector<uint32_t> pending = std::move(buckets.begin()->second);
+        buckets.erase(buckets.begin());
+
+        frontier.clear();
+        ++round;
+        for (uint32_t node : pending) {
+            if (distances[node].load(std::memory_order_relaxed) / delta == index && inFrontier[node] != round) {
+                inFrontier[node] = round;
+                frontier.push_back(node);
+            }
+        }
+
+        // Fase leve: repete enquanto vértices voltarem a cair no balde atual
+        settled.clear();
+        while (!frontier.empty()) {
+            relaxEdges(frontier, true);
+            for (uint32_t node : frontier) {
+                if (settledIn[node] != index) {
+                    settledIn[node] = index;
+                    settled.push_back(node);
+                }
+            }
+            frontier.clear();
+            ++round;
+            for (auto& buffer : improved) {
+                for (uint32_t node : buffer) {
+                    const uint64_t bucket = distances[node].load(std::memory_order_relaxed) / delta;
+                    if (bucket != index) {
+                        buckets[bucket].push_back(node);
+                    } else if (inFrontier[node] != round) {
+                        inFrontier[node] = round;
+                        frontier.push_back(node);
+                    }
+                }
+                buffer.clear();
+            }
+        }
+
+        // Fase pesada: as distâncias do balde já são finais, e estradas pesadas só alcançam baldes posteriores
+        relaxEdges(settled, false);
+        for (auto& buffer : improved) {
+            for (uint32_t node : buffer) {
+                buckets[distances[node].load(std::memory_order_relaxed) / delta].push_back(node);
+            }
+            buffer.clear();
+        }
+        numSettled += settled.size();
+    }
+
+    std::vector<uint64_t> result(numVertices);
+    parallelFor(workers, numVertices, CHUNK_SIZE, [&](unsigned, size_t begin, size_t end) {
+        for (size_t v = begin; v < end; ++v) {
+            result[v] = distances[v].load(std::memory_order_relaxed);
+        }
+    });
+    uint64_t totalScanned = 0;
+    for (uint64_t scanned : edgesScanned) {
+        totalScanned += scanned;
+    }
+    INSTRUMENT_COUNT(ShortestPathRuns, 1);
+    INSTRUMENT_COUNT(ShortestPathVerticesSettled, numSettled);
+    INSTRUMENT_COUNT(ShortestPathEdgesScanned, totalScanned);
+    return result;
+}
+
+std::vector<uint64_t> ShortestPaths::distancesFrom(const CSRGraph& graph, uint32_t source, unsigned numThreads) {
+    if (graph.numVertices() >= PARALLEL_THRESHOLD && resolveThreadCount(numThreads) > 1) {
+        return deltaStepping(graph, source, numThreads);
+    }
+    std::vector<uint64_t> distances;
+    RadixHeap heap;
+    dijkstra(graph, source, distances, heap);
+    return distances;
+}
@@ -0,0 +1,56 @@
+#include "../include/Tarjan.hpp"
+
+// Encontra as componentes fortemente conectadas utilizando o algoritmo de Tarjan
+std::vector<std::vector<uint32_t>> Tarjan::findConnectedComponents(const CSRGraph& graph) {
+    std::vector<uint32_t> componentOf;
+    uint32_t numComponents = labelComponents(graph, componentOf);
+
+    std::vector<std::vector<uint32_t>> components(numComponents);
+    for (uint32_t node = 0; node < graph.numVertices(); ++node) {
+        components[componentOf[node]].push_back(node);
+    }
+    return components;
+}
+
+// Rotula as componentes com uma única DFS iterativa sobre a lista direta (sem grafo transposto): o subconjunto
+// é o grafo inteiro, com cada vértice na sua própria posição
+uint32_t Tarjan::labelComponents(const CSRGraph& graph, std::vector<uint32_t>& componentOf) {
+    componentOf.assign(graph.numVertices(), OUTSIDE);
+    uint32_t numComponents = 0;
+    Workspace workspace;
+    auto identity = [](uint32_t vertex) { return vertex; };
+    auto assign = [&](const uint32_t* begin, const uint32_t* end) {
+        for (const uint32_t* member = begin; member != end; ++member) {
+            componentOf[*member] = numComponents;
+        }
+        ++numComponents;
+    };
+    labelRestricted(graph, graph.numVertices(), identity, identity, assign, workspace);
+    return numComponents;
+}
+
+// Mesma DFS restrita ao subconjunto; os arrays auxiliares são indexados pela posição no subconjunto
+uint32_t Tarjan::labelSubset(const CSRGraph& graph, const std::vector<uint32_t>& vertices, uint32_t firstLabel,
+                             std::vector<uint32_t>& componentOf, std::vector<uint32_t>& position) {
+    const uint32_t size = static_cast<uint32_t>(vertices.size());
+    for (uint32_t i = 0; i < size; ++i) {
+        position[vertices[i]] = i;
+    }
+
+    uint32_t label = firstLabel;
+    Workspace workspace;
+    auto vertexAt = [&vertices](uint32_t slot) { return vertices[slot]; };
+    auto slotOf = [&position](uint32_t vertex) { return position[vertex]; };
+    auto assign = [&](const uint32_t* begin, const uint32_t* end) {
+        for (const uint32_t* member = begin; member != end; ++member) {
+            componentOf[vertices[*member]] = label;
+        }
+        ++label;
+    };
+    labelRestricted(graph, size, vertexAt, slotOf, assign, workspace);
+
+    for (uint32_t vertex : vertices) {
+        position[vertex] = OUTSIDE;
+    }
+    return label;
+}
@@ -1,58 +1,423 @@
 #include "../include/Graph.hpp"
+#include "../include/EdgeListLoader.hpp"
+#include "../include/GraphSnapshot.hpp"
+#include "../include/Instrumentation.hpp"
+#include "../include/OutputWriter.hpp"
+#include "../include/QueryServer.hpp"
 #include <iostream>
 #include <vector>
 #include <string>
-#include <map>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <fstream>
+#include <sstream>
+#include <string_view>
+#include <fcntl.h>
+#include <unistd.h>
 
-int main() {
-    Graph graph; // Instância do grafo
-    std::map<std::string, int> nameToIndex; // Mapeia nomes de centros urbanos para índices
-    std::vector<std::string> indexToName;   // Mapeia índices para os nomes de centros urbanos
-
-    int numCenters, numEdges; // Número de centros urbanos e estradas
-    std::cin >> numCenters >> numEdges;
+// Exibe as opções de linha de comando aceitas pelo programa
+static void printUsage(const char* program) {
+    std::cerr << "Uso: " << program << " [opções] < entrada\n"
+              << "  --threads N            número de threads (0 = todas as disponíveis)\n"
+              << "  --capital-mode MODO    pruned | sequential | parallel | bitparallel | approximate\n"
+              << "  --approx-samples N     pivôs sorteados no modo aproximado (padrão 64)\n"
+              << "  --approx-verify K      candidatos verificados com BFS completas no modo aproximado (padrão 16)\n"
+              << "  --scc ALGORITMO        tarjan | kosaraju | parallel\n"
+              << "  --balancing MODO       flow | hungarian | sparse\n"
+              << "  --battalions MODO      all (um por componente sem a capital) | sinks (só nas componentes sumidouro)\n"
+              << "  --memory-budget MB     limite de memória: acima dele as rotas não são memorizadas e o\n"
+              << "                         balanceamento por emparelhamento cede ao fluxo de custo mínimo\n"
+              << "  --capital-stats        imprime os contadores da busca podada em stderr\n"
+              << "  --patrol-stats         imprime o custo do balanceamento das rotas em stderr\n"
+              << "  --snapshot ARQUIVO     carrega o grafo pré-processado do snapshot (texto da entrada se inválido)\n"
+              << "  --write-snapshot ARQ   grava o grafo e a análise em um snapshot binário ao final\n"
+              << "  --updates ARQUIVO      aplica lotes de \"+ origem destino [peso]\" / \"- origem destino\" (separados\n"
+              << "                         por linha em branco) e imprime o resultado atualizado após cada lote\n"
+              << "  --input ARQUIVO        lê o grafo em texto do arquivo em vez da entrada padrão\n"
+              << "  --routes-binary ARQ    grava as rotas de patrulhamento em um arquivo binário (identificadores em\n"
+              << "                         LEB128) e imprime apenas o seu número\n"
+              << "  --serve                mantém o grafo em memória e responde às consultas lidas da entrada\n"
+              << "                         padrão (o grafo vem de --input ou --snapshot)\n"
+              << "  --serve-socket CAMINHO mantém o grafo em memória e responde às consultas no socket Unix\n"
+              << "  --stage-report DESTINO mede tempo, CPU, alocações e memória de cada etapa e grava o relatório\n"
+              << "                         JSON em DESTINO (\"-\" = stderr); também via GEOGRAPH_STAGE_REPORT\n";
+}
 
-    // Lê os centros urbanos e as estradas do grafo
-    for (int i = 0; i < numEdges; ++i) {
-        std::string from, to;
-        std::cin >> from >> to;
+// Opções de linha de comando do programa
+struct ProgramOptions {
+    AnalysisOptions analysis;
+    bool printCapitalStats = false;
+    bool printPatrolStats = false;
+    std::string snapshotPath;      // Snapshot a carregar no lugar da entrada em texto
+    std::string writeSnapshotPath; // Snapshot a gravar após a análise
+    std::string updatesPath;       // Lotes de atualizações aplicados após o primeiro resultado
+    std::string inputPath;         // Entrada em texto (entrada padrão se vazio)
+    bool serve = false;            // Servidor de consultas na entrada/saída padrão
+    std::string socketPath;        // Servidor de consultas em socket Unix
+    std::string routesBinaryPath;  // Rotas gravadas em binário em vez de texto
+    std::string stageReportPath;   // Relatório das etapas ("-" = stderr; vazio = sem medição)
+};
 
-        // Adiciona novos centros urbanos ao grafo, se ainda não existem
-        if (nameToIndex.find(from) == nameToIndex.end()) {
-            nameToIndex[from] = indexToName.size();
-            indexToName.push_back(from);
-            graph.addNode(from);
+// Interpreta as opções de linha de comando; retorna false em caso de opção inválida
+static bool parseArguments(int argc, char* argv[], ProgramOptions& programOptions) {
+    AnalysisOptions& options = programOptions.analysis;
+    CapitalOptions& capitalOptions = options.capital;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            // Só dígitos: strtoul aceitaria sinal e espaços, e um texto inválido viraria 0 (todas as threads)
+            const char* text = argv[++i];
+            char* end = nullptr;
+            errno = 0;
+            const unsigned long value = std::strtoul(text, &end, 10);
+            if (!std::isdigit(static_cast<unsigned char>(text[0])) || *end != '\0' || errno == ERANGE ||
+                value > std::numeric_limits<unsigned>::max()) {
+                return false;
+            }
+            capitalOptions.numThreads = static_cast<unsigned>(value);
+        } else if (arg == "--capital-mode" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "pruned") {
+                capitalOptions.mode = CapitalMode::Pruned;
+            } else if (mode == "sequential") {
+                capitalOptions.mode = CapitalMode::Sequential;
+            } else if (mode == "parallel") {
+                capitalOptions.mode = CapitalMode::Parallel;
+            } else if (mode == "bitparallel") {
+                capitalOptions.mode = CapitalMode::BitParallel;
+            } else if (mode == "approximate") {
+                capitalOptions.mode = CapitalMode::Approximate;
+            } else {
+                return false;
+            }
+        } else if ((arg == "--approx-samples" || arg == "--approx-verify") && i + 1 < argc) {
+            char* end = nullptr;
+            const unsigned long value = std::strtoul(argv[++i], &end, 10);
+            if (*end != '\0' || value == 0 || value > UINT32_MAX) {
+                return false;
+            }
+            (arg == "--approx-samples" ? capitalOptions.samples : capitalOptions.verified) = static_cast<uint32_t>(value);
+        } else if (arg == "--scc" && i + 1 < argc) {
+            std::string algorithm = argv[++i];
+            if (algorithm == "tarjan") {
+                options.sccAlgorithm = SCCAlgorithm::Tarjan;
+            } else if (algorithm == "kosaraju") {
+                options.sccAlgorithm = SCCAlgorithm::Kosaraju;
+            } else if (algorithm == "parallel") {
+                options.sccAlgorithm = SCCAlgorithm::Parallel;
+            } else {
+                return false;
+            }
+        } else if (arg == "--balancing" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "flow") {
+                options.balancing = BalancingMode::MinCostFlow;
+            } else if (mode == "hungarian") {
+                options.balancing = BalancingMode::Hungarian;
+            } else if (mode == "sparse") {
+                options.balancing = BalancingMode::SparseHungarian;
+            } else {
+                return false;
+            }
+        } else if (arg == "--battalions" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "all") {
+                options.battalions = BattalionMode::PerComponent;
+            } else if (mode == "sinks") {
+                options.battalions = BattalionMode::SinkComponents;
+            } else {
+                return false;
+            }
+        } else if (arg == "--memory-budget" && i + 1 < argc) {
+            char* end = nullptr;
+            const unsigned long long megabytes = std::strtoull(argv[++i], &end, 10);
+            if (*end != '\0' || megabytes > (UINT64_MAX >> 20)) {
+                return false;
+            }
+            options.memoryBudget = static_cast<uint64_t>(megabytes) << 20;
+        } else if (arg == "--capital-stats") {
+            programOptions.printCapitalStats = true;
+        } else if (arg == "--patrol-stats") {
+            programOptions.printPatrolStats = true;
+        } else if (arg == "--snapshot" && i + 1 < argc) {
+            programOptions.snapshotPath = argv[++i];
+        } else if (arg == "--write-snapshot" && i + 1 < argc) {
+            programOptions.writeSnapshotPath = argv[++i];
+        } else if (arg == "--updates" && i + 1 < argc) {
+            programOptions.updatesPath = argv[++i];
+        } else if (arg == "--input" && i + 1 < argc) {
+            programOptions.inputPath = argv[++i];
+        } else if (arg == "--routes-binary" && i + 1 < argc) {
+            programOptions.routesBinaryPath = argv[++i];
+        } else if (arg == "--stage-report" && i + 1 < argc) {
+            programOptions.stageReportPath = argv[++i];
+        } else if (arg == "--serve") {
+            programOptions.serve = true;
+        } else if (arg == "--serve-socket" && i + 1 < argc) {
+            programOptions.socketPath = argv[++i];
+        } else {
+            return false;
         }
+    }
+    // No modo --serve a entrada padrão traz as consultas, então o grafo precisa vir de outro lugar
+    return !programOptions.serve || !programOptions.inputPath.empty() || !programOptions.snapshotPath.empty();
+}
+
+// Imprime os contadores da busca podada da capital em stderr, no formato JSON
+static void printCapitalSearchStats(const CapitalSearchStats& stats) {
+    std::cerr << "{\"candidates\": " << stats.candidates
+              << ", \"filteredBySCC\": " << stats.filteredBySCC
+              << ", \"bfsRuns\": " << stats.bfsRuns
+              << ", \"prunedRuns\": " << stats.prunedRuns
+              << ", \"verticesVisited\": " << stats.verticesVisited
+              << ", \"prunedAtDepth\": [";
+    for (size_t depth = 0; depth < stats.prunedAtDepth.size(); ++depth) {
+        std::cerr << (depth ? ", " : "") << stats.prunedAtDepth[depth];
+    }
+    std::cerr << "]";
+    if (stats.samples > 0) {
+        std::cerr << ", \"samples\": " << stats.samples << ", \"verified\": " << stats.verified
+                  << ", \"errorBound\": " << stats.errorBound
+                  << ", \"certified\": " << (stats.certified ? "true" : "false");
+    }
+    std::cerr << "}" << std::endl;
+}
+
+// Imprime o custo do balanceamento das rotas de patrulhamento em stderr, no formato JSON
+static void printPatrolStats(const PatrolStats& stats) {
+    std::cerr << "{\"balancedComponents\": " << stats.balancedComponents
+              << ", \"unbalancedVertices\": " << stats.unbalancedVertices
+              << ", \"extraDistance\": " << stats.extraDistance << "}" << std::endl;
+}
 
-        if (nameToIndex.find(to) == nameToIndex.end()) {
-            nameToIndex[to] = indexToName.size();
-            indexToName.push_back(to);
-            graph.addNode(to);
+// Lê os lotes de atualizações: uma alteração por linha ("+ origem destino [peso]" ou "- origem destino") e
+// lotes separados por linhas em branco; retorna false se o arquivo não abrir ou tiver uma linha malformada
+static bool readUpdateBatches(const std::string& path, std::vector<std::vector<RoadUpdate>>& batches) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    batches.emplace_back();
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string operation;
+        RoadUpdate update;
+        if (!(fields >> operation)) {
+            if (!batches.back().empty()) {
+                batches.emplace_back();
+            }
+            continue;
         }
+        if ((operation != "+" && operation != "-") || !(fields >> update.from >> update.to)) {
+            return false;
+        }
+        update.kind = operation == "+" ? RoadUpdate::Insert : RoadUpdate::Remove;
+        std::string weight;
+        if (fields >> weight && (update.kind == RoadUpdate::Remove || !EdgeListLoader::parseWeight(weight, update.weight))) {
+            return false;
+        }
+        batches.back().push_back(std::move(update));
+    }
+    if (batches.back().empty()) {
+        batches.pop_back();
+    }
+    return true;
+}
 
-        graph.addEdge(from, to); // Adiciona a estrada direcionada
+// Grava as rotas em um arquivo binário compacto: cabeçalho ("GGROUTE", versão 1 e número de rotas em 8 bytes
+// little-endian) seguido, para cada rota, do seu tamanho e dos identificadores dos centros (os mesmos da
+// tabela de nomes e do snapshot), todos em LEB128
+static const char ROUTE_FILE_MAGIC[8] = {'G', 'G', 'R', 'O', 'U', 'T', 'E', 0};
+static constexpr uint32_t ROUTE_FILE_VERSION = 1;
+
+static bool writeRouteFile(const std::string& path, Graph& graph) {
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
     }
+    bool written;
+    {
+        OutputWriter out(fd);
+        out.write(std::string_view(ROUTE_FILE_MAGIC, sizeof(ROUTE_FILE_MAGIC)));
+        const uint64_t header[] = {ROUTE_FILE_VERSION, graph.numPatrolRoutes()};
+        for (uint64_t field : header) {
+            for (int byte = 0; byte < 8; ++byte) {
+                out.put(static_cast<char>(field >> (8 * byte)));
+            }
+        }
+        graph.streamPatrolRoutes([&out](const std::vector<uint32_t>& route) {
+            out.writeVarint(route.size());
+            for (uint32_t node : route) {
+                out.writeVarint(node);
+            }
+        });
+        written = out.flush();
+    }
+    return close(fd) == 0 && written;
+}
 
+// Imprime a capital, os batalhões secundários e as rotas de patrulhamento (e os contadores pedidos). As rotas
+// são escritas à medida que ficam prontas, com os nomes copiados direto da tabela para o buffer de saída, ou
+// vão para o arquivo binário de --routes-binary, ficando na saída apenas o seu número
+static bool printResults(Graph& graph, const ProgramOptions& options, OutputWriter& out) {
+    INSTRUMENT_STAGE("results");
     // Encontra e imprime a capital do estado
-    std::cout << graph.findCapital() << std::endl;
+    out.write(graph.findCapital());
+    out.put('\n');
+    if (options.printCapitalStats) {
+        printCapitalSearchStats(graph.capitalStats());
+    }
 
     // Encontra e imprime os batalhões secundários necessários
     auto secondaryBattalions = graph.findSecondaryBattalions();
-    std::cout << secondaryBattalions.size() << std::endl;
+    out.writeNumber(secondaryBattalions.size());
+    out.put('\n');
     for (const auto& battalion : secondaryBattalions) {
-        std::cout << battalion << std::endl;
+        out.write(battalion);
+        out.put('\n');
+    }
+
+    // Encontra e imprime as rotas de patrulhamento (identificadores traduzidos para nomes apenas na escrita)
+    out.writeNumber(graph.numPatrolRoutes());
+    out.put('\n');
+    if (!options.routesBinaryPath.empty()) {
+        if (!out.flush() || !writeRouteFile(options.routesBinaryPath, graph)) {
+            std::cerr << "Não foi possível gravar as rotas: " << options.routesBinaryPath << std::endl;
+            return false;
+        }
+    } else {
+        graph.streamPatrolRoutes([&graph, &out](const std::vector<uint32_t>& route) {
+            for (size_t i = 0; i < route.size(); ++i) {
+                if (i) out.put(' '); // Evita espaço extra no final da linha
+                out.write(graph.nameOf(route[i]));
+            }
+            out.put('\n');
+        });
+    }
+
+    // Os contadores vão para stderr depois que a saída correspondente foi entregue
+    bool written = out.flush();
+    if (!written) {
+        std::cerr << "Erro ao escrever a saída" << std::endl;
+    }
+    if (options.printPatrolStats) {
+        printPatrolStats(graph.patrolStats());
+    }
+    return written;
+}
+
+// Grava o relatório das etapas, se pedido; retorna false se o destino não puder ser gravado
+static bool writeStageReport(const ProgramOptions& options) {
+    if (options.stageReportPath.empty()) {
+        return true;
+    }
+    if (!Instrumentation::writeReport(options.stageReportPath)) {
+        std::cerr << "Não foi possível gravar o relatório das etapas: " << options.stageReportPath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    ProgramOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // Medição das etapas: pela opção ou pela variável de ambiente (a opção tem precedência)
+    if (options.stageReportPath.empty()) {
+        if (const char* destination = std::getenv("GEOGRAPH_STAGE_REPORT")) {
+            options.stageReportPath = destination;
+        }
+    }
+    if (!options.stageReportPath.empty()) {
+#ifdef GEOGRAPH_INSTRUMENTATION
+        Instrumentation::enable();
+#else
+        std::cerr << "Medição das etapas desativada nesta compilação (INSTRUMENTATION=0)" << std::endl;
+#endif
+    }
+
+    Graph graph; // Instância do grafo (interna os nomes dos centros urbanos em identificadores densos)
+    graph.setAnalysisOptions(options.analysis);
+
+    // Carrega o snapshot, se houver; senão (ou se ele for inválido) lê os centros urbanos e as estradas
+    // de uma só vez (arquivo mapeado em memória quando possível)
+    bool loaded = false;
+    if (!options.snapshotPath.empty()) {
+        loaded = GraphSnapshot::load(options.snapshotPath, graph);
+        if (!loaded && options.serve && options.inputPath.empty()) {
+            // No modo --serve a entrada padrão traz as consultas e nunca é lida como grafo
+            std::cerr << "Snapshot inválido ou ausente: " << options.snapshotPath
+                      << " (use --input para ler o grafo em texto no modo --serve)" << std::endl;
+            return 1;
+        }
+        if (!loaded) {
+            std::cerr << "Snapshot inválido ou ausente: " << options.snapshotPath << "; lendo a entrada em texto"
+                      << std::endl;
+        }
+    }
+    if (!loaded) {
+        int fd = options.inputPath.empty() ? STDIN_FILENO : open(options.inputPath.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "Não foi possível abrir a entrada: " << options.inputPath << std::endl;
+            return 1;
+        }
+        loaded = EdgeListLoader::load(fd, graph);
+        if (fd != STDIN_FILENO) {
+            close(fd);
+        }
+        if (!loaded) {
+            std::cerr << "Entrada ilegível ou inválida: esperado \"numCentros numEstradas\" seguido das estradas"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    // Modos servidor: o grafo e a análise ficam em memória e as consultas são respondidas até o fim
+    if (options.serve || !options.socketPath.empty()) {
+        QueryServer server(graph);
+        if (!options.socketPath.empty()) {
+            if (!server.serveSocket(options.socketPath)) {
+                std::cerr << "Não foi possível abrir o socket: " << options.socketPath << std::endl;
+                return 1;
+            }
+        } else {
+            server.serveStream(std::cin, std::cout);
+        }
+        return writeStageReport(options) ? 0 : 1;
+    }
+
+    // Lotes de atualizações, lidos antes da análise para que um arquivo inválido não produza saída parcial
+    std::vector<std::vector<RoadUpdate>> batches;
+    if (!options.updatesPath.empty() && !readUpdateBatches(options.updatesPath, batches)) {
+        std::cerr << "Arquivo de atualizações inválido: " << options.updatesPath << std::endl;
+        return 1;
     }
 
-    // Encontra e imprime as rotas de patrulhamento
-    auto patrolRoutes = graph.findPatrolRoutes();
-    std::cout << patrolRoutes.size() << std::endl;
-    for (const auto& route : patrolRoutes) {
-        for (size_t i = 0; i < route.size(); ++i) {
-            std::cout << route[i];
-            if (i < route.size() - 1) std::cout << " "; // Evita espaço extra no final da linha
+    // Saída bufferizada: nada de flush por linha, e os nomes vão da tabela direto para o buffer
+    OutputWriter out(STDOUT_FILENO);
+    if (!printResults(graph, options, out)) {
+        return 1;
+    }
+
+    // Cada lote atualiza a análise incrementalmente e o resultado é impresso de novo
+    for (const auto& batch : batches) {
+        graph.applyUpdates(batch);
+        if (!printResults(graph, options, out)) {
+            return 1;
         }
-        std::cout << std::endl;
     }
 
-    return 0;
+    if (!options.writeSnapshotPath.empty() && !GraphSnapshot::write(options.writeSnapshotPath, graph, true)) {
+        std::cerr << "Não foi possível gravar o snapshot: " << options.writeSnapshotPath << std::endl;
+        return 1;
+    }
+
+    return writeStageReport(options) ? 0 : 1;
 }
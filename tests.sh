@@ -11,6 +11,9 @@ PROGRAM="./tp1"
 
 TEMP_OUTPUT="temp_output.txt"
 
+# Scratch snapshot that test argument files may write and read back
+TEMP_SNAPSHOT="temp_snapshot.bin"
+
 total_tests=0
 failed_tests=0
 
@@ -56,7 +59,17 @@ for input_file in "$INPUT_DIR"/*.txt; do
 
     total_tests=$((total_tests + 1))
 
-    "$PROGRAM" < "$input_file" > "$TEMP_OUTPUT"
+    # An optional NAME.args file holds one invocation per line (extra arguments, fed the same input);
+    # the outputs of all invocations are concatenated
+    args_file="$INPUT_DIR/${filename%.txt}.args"
+    if [ -f "$args_file" ]; then
+        : > "$TEMP_OUTPUT"
+        while IFS= read -r args || [ -n "$args" ]; do
+            $PROGRAM $args < "$input_file" >> "$TEMP_OUTPUT"
+        done < "$args_file"
+    else
+        "$PROGRAM" < "$input_file" > "$TEMP_OUTPUT"
+    fi
 
     if ! diff -q "$TEMP_OUTPUT" "$expected_output_file" > /dev/null; then
         echo "Test '$filename': FAILED"
@@ -70,7 +83,7 @@ for input_file in "$INPUT_DIR"/*.txt; do
     fi
 done
 
-rm -f "$TEMP_OUTPUT"
+rm -f "$TEMP_OUTPUT" "$TEMP_SNAPSHOT"
 
 if [ "$total_tests" -gt 0 ]; then
     fail_percent=$(printf "%.2f" "$(echo "scale=4; ($failed_tests / $total_tests) * 100" | bc)")